@@ -0,0 +1,43 @@
+/**
+ * Build time compiler of SVG documents into the binary form of `CompiledSvg`.
+ *
+ * Usage: svgscene-compiler <input.svg> <output.svgc>
+ */
+
+#include "svgscene/svgcompiled.h"
+
+#include <QApplication>
+#include <QSaveFile>
+#include <cstdio>
+
+using namespace svgscene;
+
+int main(int argc, char *argv[]) {
+    // Items with text need fonts, but no display is available during the build.
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) { qputenv("QT_QPA_PLATFORM", "offscreen"); }
+    QApplication app(argc, argv);
+
+    const QStringList args = QApplication::arguments();
+    if (args.size() != 3) {
+        fprintf(stderr, "Usage: %s <input.svg> <output.svgc>\n", argv[0]);
+        return 2;
+    }
+
+    QFile input(args.at(1));
+    if (!input.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "Cannot open %s\n", qPrintable(args.at(1)));
+        return 1;
+    }
+    const CompiledSvg compiled = CompiledSvg::fromFile(&input);
+    if (compiled.isEmpty()) {
+        fprintf(stderr, "No items found in %s\n", qPrintable(args.at(1)));
+        return 1;
+    }
+
+    QSaveFile output(args.at(2));
+    if (!output.open(QIODevice::WriteOnly) || !compiled.save(&output) || !output.commit()) {
+        fprintf(stderr, "Cannot write %s\n", qPrintable(args.at(2)));
+        return 1;
+    }
+    return 0;
+}
@@ -31,6 +31,10 @@ void SimpleTextItem::setText(const QString &text) {
     }
 }
 
+QTransform SimpleTextItem::baseTransform() const {
+    return m_origTransformLoaded ? m_origTransform : transform();
+}
+
 void SimpleTextItem::paint(
     QPainter *painter,
     const QStyleOptionGraphicsItem *option,
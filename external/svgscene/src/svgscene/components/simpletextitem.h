@@ -13,6 +13,8 @@ public:
     explicit SimpleTextItem(const CssAttributes &css, QGraphicsItem *parent = nullptr);
 
     void setText(const QString &text);
+    /** Transformation without the offset applied for alignment to the text anchor. */
+    QTransform baseTransform() const;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
 
 private:
@@ -0,0 +1,209 @@
+#include "svgcompiled.h"
+
+#include "components/groupitem.h"
+#include "components/hyperlinkitem.h"
+#include "components/simpletextitem.h"
+#include "svghandler.h"
+#include "svgmetadata.h"
+#include "utils/logging.h"
+
+#include <QDataStream>
+#include <QFont>
+#include <QGraphicsItem>
+#include <QGraphicsScene>
+#include <typeinfo>
+
+LOG_CATEGORY("svgscene.compiled");
+
+namespace svgscene {
+
+static QFont fontFromDescription(const QString &description) {
+    QFont font;
+    font.fromString(description);
+    return font;
+}
+
+CompiledSvg CompiledSvg::fromFileName(const QString &filename) {
+    QFile file(filename);
+    file.open(QIODevice::ReadOnly);
+    return fromFile(&file);
+}
+
+CompiledSvg CompiledSvg::fromFile(QFile *file) {
+    CompiledSvg compiled;
+    // Items are parsed into a private scene, which is dropped once they are recorded.
+    QGraphicsScene scene;
+    SvgDocument document = parseFromFile(&scene, file);
+    compiled.record(document.getRoot().getElement(), -1);
+    return compiled;
+}
+
+CompiledSvg CompiledSvg::fromCompiledFile(QIODevice *device) {
+    QDataStream in(device);
+    in.setVersion(QDataStream::Qt_5_9);
+    quint32 magic = 0, version = 0, count = 0;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != FILE_MAGIC || version != FILE_VERSION) {
+        WARN() << "compiled document has unknown format";
+        return {};
+    }
+
+    // Count comes from the file, it must not drive the allocation unchecked. Every node takes
+    // more than one byte of the stream.
+    if (count > MAX_NODES || (!device->isSequential() && count > device->bytesAvailable())) {
+        WARN() << "compiled document is corrupted";
+        return {};
+    }
+
+    CompiledSvg compiled;
+    compiled.m_nodes.reserve(static_cast<int>(count));
+    for (quint32 i = 0; i < count; i++) {
+        Node node {};
+        quint8 kind = 0;
+        qint32 parent = 0;
+        double text_width = 0;
+        XmlAttributes xml_attributes;
+        CssAttributes css_attributes;
+        in >> kind >> parent >> node.transform >> xml_attributes >> css_attributes >> node.pen
+            >> node.brush >> node.rect >> node.path >> node.font >> node.text >> text_width
+            >> node.textColor;
+        // Parents precede their children in document order.
+        if (in.status() != QDataStream::Ok || kind > static_cast<quint8>(Kind::Text)
+            || parent < -1 || parent >= static_cast<qint32>(i) || (parent < 0) != (i == 0)) {
+            WARN() << "compiled document is corrupted";
+            return {};
+        }
+        node.kind = static_cast<Kind>(kind);
+        node.parent = parent;
+        node.textWidth = text_width;
+        node.xmlAttributes = QVariant::fromValue(xml_attributes);
+        node.cssAttributes = QVariant::fromValue(css_attributes);
+        compiled.m_nodes.append(node);
+    }
+    return compiled;
+}
+
+bool CompiledSvg::save(QIODevice *device) const {
+    QDataStream out(device);
+    out.setVersion(QDataStream::Qt_5_9);
+    out << FILE_MAGIC << FILE_VERSION << static_cast<quint32>(m_nodes.size());
+    for (const Node &node : m_nodes) {
+        out << static_cast<quint8>(node.kind) << static_cast<qint32>(node.parent) << node.transform
+            << node.xmlAttributes.value<XmlAttributes>()
+            << node.cssAttributes.value<CssAttributes>() << node.pen << node.brush << node.rect
+            << node.path << node.font << node.text << static_cast<double>(node.textWidth)
+            << node.textColor;
+    }
+    return out.status() == QDataStream::Ok;
+}
+
+SvgDocument CompiledSvg::instantiate(QGraphicsScene *scene) const {
+    QVector<QGraphicsItem *> items;
+    items.reserve(m_nodes.size());
+    for (const Node &node : m_nodes) {
+        QGraphicsItem *item = createItem(node);
+        if (node.parent >= 0) { item->setParentItem(items.at(node.parent)); }
+        items.append(item);
+    }
+    // The tree is built first and added to the scene as a whole.
+    if (!items.isEmpty()) { scene->addItem(items.first()); }
+    return SvgDocument(items.value(0));
+}
+
+void CompiledSvg::record(const QGraphicsItem *item, int parent) {
+    Node node {};
+    node.parent = parent;
+    node.transform = item->transform();
+    if (auto *text = dynamic_cast<const SimpleTextItem *>(item)) {
+        node.kind = Kind::SimpleText;
+        node.transform = text->baseTransform();
+        node.font = text->font().toString();
+        node.text = text->text();
+    } else if (auto *text = dynamic_cast<const QGraphicsTextItem *>(item)) {
+        node.kind = Kind::Text;
+        node.font = text->font().toString();
+        node.text = text->toPlainText();
+        node.textWidth = text->textWidth();
+        node.textColor = text->defaultTextColor();
+    } else if (dynamic_cast<const HyperlinkItem *>(item)) {
+        node.kind = Kind::Hyperlink;
+    } else if (dynamic_cast<const GroupItem *>(item)) {
+        node.kind = Kind::Group;
+    } else if (dynamic_cast<const QGraphicsRectItem *>(item)) {
+        node.kind = Kind::Rect;
+    } else if (dynamic_cast<const QGraphicsEllipseItem *>(item)) {
+        node.kind = Kind::Ellipse;
+    } else if (dynamic_cast<const QGraphicsPathItem *>(item)) {
+        node.kind = Kind::Path;
+    } else {
+        WARN() << "unsupported item skipped with its children:" << typeid(*item).name();
+        return;
+    }
+
+    if (auto *rect_item = dynamic_cast<const QGraphicsRectItem *>(item)) {
+        node.rect = rect_item->rect();
+    } else if (auto *ellipse_item = dynamic_cast<const QGraphicsEllipseItem *>(item)) {
+        node.rect = ellipse_item->rect();
+    } else if (auto *path_item = dynamic_cast<const QGraphicsPathItem *>(item)) {
+        node.path = path_item->path();
+    }
+    if (auto *shape_item = dynamic_cast<const QAbstractGraphicsShapeItem *>(item)) {
+        node.pen = shape_item->pen();
+        node.brush = shape_item->brush();
+    }
+    node.xmlAttributes = item->data(static_cast<int>(MetadataType::XmlAttributes));
+    node.cssAttributes = item->data(static_cast<int>(MetadataType::CssAttributes));
+
+    const int index = m_nodes.size();
+    m_nodes.append(node);
+    for (const QGraphicsItem *child : item->childItems()) {
+        record(child, index);
+    }
+}
+
+QGraphicsItem *CompiledSvg::createItem(const Node &node) {
+    QGraphicsItem *item = nullptr;
+    switch (node.kind) {
+    case Kind::Rect: item = new QGraphicsRectItem(node.rect); break;
+    case Kind::Group: {
+        auto *group = new GroupItem();
+        group->setRect(node.rect);
+        item = group;
+        break;
+    }
+    case Kind::Hyperlink: {
+        auto *hyperlink = new HyperlinkItem();
+        hyperlink->setRect(node.rect);
+        item = hyperlink;
+        break;
+    }
+    case Kind::Ellipse: item = new QGraphicsEllipseItem(node.rect); break;
+    case Kind::Path: item = new QGraphicsPathItem(node.path); break;
+    case Kind::SimpleText:
+        item = new SimpleTextItem(node.cssAttributes.value<CssAttributes>());
+        break;
+    case Kind::Text: item = new QGraphicsTextItem(); break;
+    }
+
+    if (auto *shape_item = dynamic_cast<QAbstractGraphicsShapeItem *>(item)) {
+        shape_item->setPen(node.pen);
+        shape_item->setBrush(node.brush);
+    }
+    if (!node.transform.isIdentity()) { item->setTransform(node.transform); }
+    item->setData(static_cast<int>(MetadataType::XmlAttributes), node.xmlAttributes);
+    item->setData(static_cast<int>(MetadataType::CssAttributes), node.cssAttributes);
+
+    // Text goes last, alignment to the text anchor depends on the font and the transformation.
+    if (auto *text = dynamic_cast<SimpleTextItem *>(item)) {
+        text->setFont(fontFromDescription(node.font));
+        if (!node.text.isEmpty()) { text->setText(node.text); }
+    } else if (auto *text = dynamic_cast<QGraphicsTextItem *>(item)) {
+        text->setFont(fontFromDescription(node.font));
+        text->setDefaultTextColor(node.textColor);
+        text->setTextWidth(node.textWidth);
+        if (!node.text.isEmpty()) { text->setPlainText(node.text); }
+    }
+    return item;
+}
+
+} // namespace svgscene
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "svgdocument.h"
+
+#include <QBrush>
+#include <QColor>
+#include <QFile>
+#include <QIODevice>
+#include <QPainterPath>
+#include <QPen>
+#include <QTransform>
+#include <QVariant>
+#include <QVector>
+
+class QGraphicsScene;
+
+namespace svgscene {
+
+/**
+ * SVG document parsed once and kept independently of any scene.
+ *
+ * Building a scene from a large SVG is dominated by the parsing itself (XML, style cascade, path
+ * data and transformations). The compiled document stores the resulting items as a flat list in
+ * document order, so any number of equivalent scenes can be instantiated from it without
+ * touching the source again.
+ *
+ * The compiled document can be saved in a binary form (see `svgscene-compiler`), which is read
+ * without parsing the SVG at all. Fonts are kept as descriptions, text is laid out with the fonts
+ * available when the scene is instantiated.
+ */
+class CompiledSvg {
+public:
+    static CompiledSvg fromFileName(const QString &filename);
+    static CompiledSvg fromFile(QFile *file);
+    /** Read document written by `save`. Result is empty when data are not readable. */
+    static CompiledSvg fromCompiledFile(QIODevice *device);
+
+    /** Write document in the binary form read by `fromCompiledFile`. */
+    bool save(QIODevice *device) const;
+
+    [[nodiscard]] bool isEmpty() const { return m_nodes.isEmpty(); }
+
+    /** Create items of the document in the scene (same result as `parseFromFile`). */
+    SvgDocument instantiate(QGraphicsScene *scene) const;
+
+private:
+    enum class Kind : quint8 {
+        Rect,
+        Group,
+        Hyperlink,
+        Ellipse,
+        Path,
+        SimpleText,
+        Text,
+    };
+
+    struct Node {
+        Kind kind;
+        /** Index of the parent node, -1 for the root. */
+        int parent;
+        QTransform transform;
+        QVariant xmlAttributes;
+        QVariant cssAttributes;
+        QPen pen;
+        QBrush brush;
+        QRectF rect;
+        QPainterPath path;
+        /** Font is kept as a description, it is resolved when the item is created. */
+        QString font;
+        QString text;
+        qreal textWidth = -1;
+        QColor textColor;
+    };
+
+    /** Identifies binary form of the compiled document, bump version on any change of layout. */
+    static constexpr quint32 FILE_MAGIC = 0x53564743; // SVGC
+    static constexpr quint32 FILE_VERSION = 1;
+    /** Limit of nodes read from the binary form, far above any real document. */
+    static constexpr quint32 MAX_NODES = 1U << 20;
+
+    void record(const QGraphicsItem *item, int parent);
+    static QGraphicsItem *createItem(const Node &node);
+
+    QVector<Node> m_nodes;
+};
+
+} // namespace svgscene
@@ -3,6 +3,7 @@
 #include "common/math/bit_ops.h"
 #include "memory/address.h"
 
+#include <algorithm>
 #include <climits>
 #include <utility>
 
@@ -29,6 +30,114 @@ bool FmeSymbolDb::getValue(FmeValue &value, QString name) {
     return false;
 }
 
+int FmeSymbolSlots::slot(const QString &name) {
+    auto it = index.constFind(name);
+    if (it != index.cend()) { return it.value(); }
+    const int slot = names.size();
+    index.insert(name, slot);
+    names.append(name);
+    return slot;
+}
+
+const QString &FmeSymbolSlots::name(int slot) const {
+    return names.at(slot);
+}
+
+void FmeSymbolSlots::resolve(FmeSymbolDb *symdb) {
+    values.assign(names.size(), 0);
+    found.assign(names.size(), false);
+    if (symdb == nullptr) { return; }
+    for (int slot = 0; slot < names.size(); slot++) {
+        FmeValue value;
+        if (symdb->getValue(value, names.at(slot))) {
+            values[slot] = value;
+            found[slot] = true;
+        }
+    }
+}
+
+void FmeCode::clear() {
+    ops.clear();
+    depth = 0;
+    max_depth = 0;
+}
+
+void FmeCode::push_constant(FmeValue value) {
+    ops.push_back({ Op::CONSTANT, value, nullptr, nullptr });
+    max_depth = std::max(max_depth, ++depth);
+}
+
+void FmeCode::push_symbol(int slot) {
+    ops.push_back({ Op::SYMBOL, slot, nullptr, nullptr });
+    max_depth = std::max(max_depth, ++depth);
+}
+
+void FmeCode::apply_unary(
+    FmeValue (*op)(FmeValue &a, machine::Address inst_addr),
+    bool address_dependent) {
+    if (!address_dependent && ops.back().kind == Op::CONSTANT) {
+        ops.back().value = op(ops.back().value, machine::Address::null());
+        return;
+    }
+    ops.push_back({ Op::UNARY, 0, op, nullptr });
+}
+
+void FmeCode::apply_binary(FmeValue (*op)(FmeValue &a, FmeValue &b)) {
+    depth--;
+    const size_t count = ops.size();
+    if (ops[count - 1].kind == Op::CONSTANT && ops[count - 2].kind == Op::CONSTANT) {
+        ops[count - 2].value = op(ops[count - 2].value, ops[count - 1].value);
+        ops.pop_back();
+        return;
+    }
+    ops.push_back({ Op::BINARY, 0, nullptr, op });
+}
+
+bool FmeCode::eval(
+    FmeValue &value,
+    const FmeSymbolSlots &symbols,
+    QString &error,
+    machine::Address inst_addr) const {
+    // Expressions in assembly sources are shallow, the heap is used only for extreme ones.
+    FmeValue small_stack[16];
+    std::vector<FmeValue> large_stack;
+    FmeValue *stack = small_stack;
+    if (max_depth > 16) {
+        large_stack.resize(max_depth);
+        stack = large_stack.data();
+    }
+    int top = 0;
+    for (const Op &op : ops) {
+        switch (op.kind) {
+        case Op::CONSTANT: stack[top++] = op.value; break;
+        case Op::SYMBOL:
+            if (!symbols.value(static_cast<int>(op.value), stack[top])) {
+                error = QString("value for symbol \"%1\" not found")
+                            .arg(symbols.name(static_cast<int>(op.value)));
+                return false;
+            }
+            top++;
+            break;
+        case Op::UNARY: stack[top - 1] = op.unary(stack[top - 1], inst_addr); break;
+        case Op::BINARY:
+            top--;
+            stack[top - 1] = op.binary(stack[top - 1], stack[top]);
+            break;
+        }
+    }
+    if (top != 1) { return false; }
+    value = stack[0];
+    return true;
+}
+
+std::vector<int> FmeCode::symbol_slots() const {
+    std::vector<int> slots;
+    for (const Op &op : ops) {
+        if (op.kind == Op::SYMBOL) { slots.push_back(static_cast<int>(op.value)); }
+    }
+    return slots;
+}
+
 FmeNode::FmeNode(int priority) {
     prio = priority;
 }
@@ -80,6 +189,12 @@ QString FmeNodeConstant::dump() {
     return QString::number(value);
 }
 
+bool FmeNodeConstant::compile(FmeCode &code, FmeSymbolSlots &symbols) {
+    std::ignore = symbols;
+    code.push_constant(value);
+    return true;
+}
+
 FmeNodeSymbol::FmeNodeSymbol(QString &name) : FmeNode(INT_MAX) {
     this->name = name;
 }
@@ -106,14 +221,21 @@ QString FmeNodeSymbol::dump() {
     return name;
 }
 
+bool FmeNodeSymbol::compile(FmeCode &code, FmeSymbolSlots &symbols) {
+    code.push_symbol(symbols.slot(name));
+    return true;
+}
+
 FmeNodeUnaryOp::FmeNodeUnaryOp(
     int priority,
     FmeValue (*op)(FmeValue &a, machine::Address inst_addr),
-    QString description)
+    QString description,
+    bool address_dependent)
     : FmeNode(priority) {
     this->operand_a = nullptr;
     this->op = op;
     this->description = std::move(description);
+    this->address_dependent = address_dependent;
 }
 
 FmeNodeUnaryOp::~FmeNodeUnaryOp() {
@@ -145,6 +267,12 @@ QString FmeNodeUnaryOp::dump() {
     return "(" + description + " " + (operand_a ? operand_a->dump() : "nullptr") + ")";
 }
 
+bool FmeNodeUnaryOp::compile(FmeCode &code, FmeSymbolSlots &symbols) {
+    if (!operand_a || !operand_a->compile(code, symbols)) { return false; }
+    code.apply_unary(op, address_dependent);
+    return true;
+}
+
 FmeNodeBinaryOp::FmeNodeBinaryOp(
     int priority,
     FmeValue (*op)(FmeValue &a, FmeValue &b),
@@ -192,6 +320,15 @@ QString FmeNodeBinaryOp::dump() {
            + (operand_b ? operand_b->dump() : "nullptr") + ")";
 }
 
+bool FmeNodeBinaryOp::compile(FmeCode &code, FmeSymbolSlots &symbols) {
+    if (!operand_a || !operand_b) { return false; }
+    if (!operand_a->compile(code, symbols) || !operand_b->compile(code, symbols)) {
+        return false;
+    }
+    code.apply_binary(op);
+    return true;
+}
+
 FmeExpression::FmeExpression() : FmeNode(0) {
     root = nullptr;
 }
@@ -237,6 +374,7 @@ bool FmeExpression::parse(const QString &expression, QString &error) {
             if (i >= expression.size()) { break; }
             FmeValue (*binary_op)(FmeValue &a, FmeValue &b) = nullptr;
             FmeValue (*unary_op)(FmeValue &a, machine::Address inst_addr) = nullptr;
+            bool address_dependent = false;
             int prio = base_prio;
 
             optxtx = ch;
@@ -262,6 +400,7 @@ bool FmeExpression::parse(const QString &expression, QString &error) {
                 } else if (expr.startsWith(QStringLiteral("pcrel_hi("))) {
                     i += 8;
                     optxtx = QStringLiteral("%pcrel_hi");
+                    address_dependent = true;
                     unary_op = [](FmeValue &a, machine::Address inst_addr) -> FmeValue {
                         return get_bits(a - inst_addr.get_raw(), 31, 12)
                                + get_bit(a - inst_addr.get_raw(), 11);
@@ -269,6 +408,7 @@ bool FmeExpression::parse(const QString &expression, QString &error) {
                 } else if (expr.startsWith(QStringLiteral("pcrel_lo("))) {
                     i += 8;
                     optxtx = QStringLiteral("%pcrel_lo");
+                    address_dependent = true;
                     unary_op = [](FmeValue &a, machine::Address inst_addr) -> FmeValue {
                         return sign_extend(get_bits(a - inst_addr.get_raw() + 4, 11, 0), 12);
                     };
@@ -332,7 +472,8 @@ bool FmeExpression::parse(const QString &expression, QString &error) {
                     ok = node->insert(new FmeNodeBinaryOp(prio, binary_op, child, optxtx));
                     is_unary = true;
                 } else {
-                    ok = node->insert(new FmeNodeUnaryOp(prio, unary_op, optxtx));
+                    ok = node->insert(
+                        new FmeNodeUnaryOp(prio, unary_op, optxtx, address_dependent));
                 }
                 if (!ok) {
                     error = QString("parse stuck at \"%1\"").arg(QString(ch));
@@ -374,3 +515,9 @@ FmeNode *FmeExpression::child() {
 QString FmeExpression::dump() {
     return "(" + (root ? root->dump() : "nullptr") + ")";
 }
+
+bool FmeExpression::compile(FmeCode &code, FmeSymbolSlots &symbols) {
+    code.clear();
+    if (!root) { return false; }
+    return root->compile(code, symbols);
+}
@@ -3,7 +3,10 @@
 
 #include "memory/address.h"
 
+#include <QHash>
 #include <QString>
+#include <QStringList>
+#include <vector>
 
 namespace fixmatheval {
 
@@ -15,6 +18,62 @@ public:
     virtual bool getValue(FmeValue &value, QString name) = 0;
 };
 
+/**
+ * Symbols referenced by compiled expressions. Each distinct name has its own slot, so a symbol is
+ * looked up only once for any number of expressions.
+ */
+class FmeSymbolSlots {
+public:
+    int slot(const QString &name);
+    [[nodiscard]] const QString &name(int slot) const;
+    /** Looks up values of all symbols in the database. */
+    void resolve(FmeSymbolDb *symdb);
+    bool value(int slot, FmeValue &value) const {
+        if (!found[slot]) { return false; }
+        value = values[slot];
+        return true;
+    }
+
+private:
+    QHash<QString, int> index;
+    QStringList names;
+    std::vector<FmeValue> values;
+    std::vector<bool> found;
+};
+
+/**
+ * Expression compiled to a flat sequence of stack machine operations with constant subexpressions
+ * folded.
+ */
+class FmeCode {
+public:
+    void clear();
+    void push_constant(FmeValue value);
+    void push_symbol(int slot);
+    void
+    apply_unary(FmeValue (*op)(FmeValue &a, machine::Address inst_addr), bool address_dependent);
+    void apply_binary(FmeValue (*op)(FmeValue &a, FmeValue &b));
+    bool eval(
+        FmeValue &value,
+        const FmeSymbolSlots &symbols,
+        QString &error,
+        machine::Address inst_addr) const;
+    /** Slots of symbols used by the expression. */
+    [[nodiscard]] std::vector<int> symbol_slots() const;
+
+private:
+    struct Op {
+        enum Kind { CONSTANT, SYMBOL, UNARY, BINARY } kind;
+        /** Constant value or symbol slot. */
+        FmeValue value;
+        FmeValue (*unary)(FmeValue &a, machine::Address inst_addr);
+        FmeValue (*binary)(FmeValue &a, FmeValue &b);
+    };
+    std::vector<Op> ops;
+    int depth = 0;
+    int max_depth = 0;
+};
+
 class FmeNode {
 public:
     explicit FmeNode(int priority);
@@ -25,6 +84,7 @@ public:
     virtual bool insert(FmeNode *node);
     virtual FmeNode *child();
     virtual QString dump() = 0;
+    virtual bool compile(FmeCode &code, FmeSymbolSlots &symbols) = 0;
     FmeNode *find_last_child();
     [[nodiscard]] int priority() const;
 
@@ -39,6 +99,7 @@ public:
     bool
     eval(FmeValue &value, FmeSymbolDb *symdb, QString &error, machine::Address inst_addr) override;
     QString dump() override;
+    bool compile(FmeCode &code, FmeSymbolSlots &symbols) override;
 
 private:
     FmeValue value;
@@ -51,6 +112,7 @@ public:
     bool
     eval(FmeValue &value, FmeSymbolDb *symdb, QString &error, machine::Address inst_addr) override;
     QString dump() override;
+    bool compile(FmeCode &code, FmeSymbolSlots &symbols) override;
 
 private:
     QString name;
@@ -61,18 +123,22 @@ public:
     FmeNodeUnaryOp(
         int priority,
         FmeValue (*op)(FmeValue &a, machine::Address inst_addr),
-        QString description = "??");
+        QString description = "??",
+        bool address_dependent = false);
     ~FmeNodeUnaryOp() override;
     bool
     eval(FmeValue &value, FmeSymbolDb *symdb, QString &error, machine::Address inst_addr) override;
     bool insert(FmeNode *node) override;
     FmeNode *child() override;
     QString dump() override;
+    bool compile(FmeCode &code, FmeSymbolSlots &symbols) override;
 
 private:
     FmeValue (*op)(FmeValue &a, machine::Address inst_addr);
     FmeNode *operand_a;
     QString description;
+    /** Result depends on the instruction address, it cannot be folded. */
+    bool address_dependent;
 };
 
 class FmeNodeBinaryOp : public FmeNode {
@@ -88,6 +154,7 @@ public:
     bool insert(FmeNode *node) override;
     FmeNode *child() override;
     QString dump() override;
+    bool compile(FmeCode &code, FmeSymbolSlots &symbols) override;
 
 private:
     FmeValue (*op)(FmeValue &a, FmeValue &b);
@@ -106,6 +173,8 @@ public:
     bool insert(FmeNode *node) override;
     FmeNode *child() override;
     QString dump() override;
+    /** Compiles the parsed expression, fails for an incomplete one. */
+    bool compile(FmeCode &code, FmeSymbolSlots &symbols) override;
 
 private:
     FmeNode *root;
@@ -6,8 +6,12 @@
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QObject>
+#include <QSet>
 #include <QString>
+#include <cstring>
+#include <memory>
 
 using namespace fixmatheval;
 using machine::Address;
@@ -57,6 +61,13 @@ SimpleAsm::~SimpleAsm() {
     clear();
 }
 
+void SimpleAsmIncrementalState::clear() {
+    valid = false;
+    lines.clear();
+    symbols.clear();
+    expressions.clear();
+}
+
 void SimpleAsm::clear() {
     symtab = nullptr;
     mem = nullptr;
@@ -65,26 +76,184 @@ void SimpleAsm::clear() {
     }
     error_occured = false;
     fatal_occured = false;
+    written = false;
+    incremental = nullptr;
+    lines.clear();
+    next_lines.clear();
+    defined_symbols.clear();
+    current_line = nullptr;
 }
 
 void SimpleAsm::setup(
     machine::FrontendMemory *mem,
     SymbolTableDb *symtab,
     machine::Address address,
-    machine::Xlen xlen) {
+    machine::Xlen xlen,
+    SimpleAsmIncrementalState *incremental) {
     this->mem = mem;
     this->symtab = symtab;
     this->address = address;
     this->symtab->setSymbol("XLEN", static_cast<uint64_t>(xlen), sizeof(uint64_t));
+    this->incremental = incremental;
+    if (incremental != nullptr && (!incremental->valid || incremental->xlen != xlen)) {
+        incremental->clear();
+        incremental->valid = true;
+        incremental->xlen = xlen;
+    }
+}
+
+void SimpleAsm::define_symbol(const QString &name, SymbolValue value, SymbolSize size) {
+    symtab->setSymbol(name, value, size);
+    if (incremental != nullptr) { defined_symbols.insert(name, value); }
+}
+
+void SimpleAsm::mark_uncacheable() {
+    if (current_line != nullptr) { current_line->cacheable = false; }
+}
+
+void SimpleAsm::note_written(machine::Address location, size_t size) {
+    const Address last = location + (size - 1);
+    if (!written) {
+        written_start = location;
+        written_last = last;
+        written = true;
+        return;
+    }
+    if (location < written_start) { written_start = location; }
+    if (last > written_last) { written_last = last; }
+}
+
+void SimpleAsm::emit_u8(machine::Address location, uint8_t value) {
+    if (current_line != nullptr) {
+        const int64_t offset = location - current_line->start;
+        if (offset >= 0 && offset <= current_line->bytes.size()) {
+            if (offset == current_line->bytes.size()) {
+                current_line->bytes.append(static_cast<char>(value));
+            } else {
+                current_line->bytes[static_cast<int>(offset)] = static_cast<char>(value);
+            }
+            return;
+        }
+        current_line->cacheable = false;
+    }
+    if (!fatal_occured) {
+        mem->write_u8(location, value, ae::INTERNAL);
+        note_written(location, 1);
+    }
+}
+
+void SimpleAsm::emit_u32(machine::Address location, uint32_t value) {
+    if (current_line != nullptr) {
+        // Kept in the same byte order as in the simulated memory.
+        const uint32_t raw = byteswap_if(value, mem->simulated_machine_endian != NATIVE_ENDIAN);
+        for (size_t i = 0; i < sizeof(raw); i++) {
+            emit_u8(location + i, reinterpret_cast<const uint8_t *>(&raw)[i]);
+        }
+        return;
+    }
+    if (!fatal_occured) {
+        mem->write_u32(location, value, ae::INTERNAL);
+        note_written(location, 4);
+    }
+}
+
+void SimpleAsm::write_changed(machine::Address start, const QByteArray &bytes) {
+    const bool swap = mem->simulated_machine_endian != NATIVE_ENDIAN;
+    int offset = 0;
+    while (offset < bytes.size()) {
+        const Address location = start + offset;
+        if (((location.get_raw() & 3) == 0) && (bytes.size() - offset >= 4)) {
+            uint32_t value;
+            memcpy(&value, bytes.constData() + offset, sizeof(value));
+            value = byteswap_if(value, swap);
+            if (mem->read_u32(location, ae::INTERNAL) != value) {
+                mem->write_u32(location, value, ae::INTERNAL);
+                note_written(location, 4);
+            }
+            offset += 4;
+        } else {
+            const auto value = static_cast<uint8_t>(bytes.at(offset));
+            if (mem->read_u8(location, ae::INTERNAL) != value) {
+                mem->write_u8(location, value, ae::INTERNAL);
+                note_written(location, 1);
+            }
+            offset += 1;
+        }
+    }
 }
 
 static const machine::BitArg wordArg = { { { 32, 0 } }, 0 };
 
+static inline bool is_space(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\v' || ch == '\f' || ch == '\r';
+}
+
+static inline bool starts_with(const char *str, int length, const char *prefix) {
+    const int prefix_length = static_cast<int>(strlen(prefix));
+    return length >= prefix_length && memcmp(str, prefix, prefix_length) == 0;
+}
+
 bool SimpleAsm::process_line(
     const QString &line,
     const QString &filename,
     int line_number,
     QString *error_ptr) {
+    const QByteArray utf8 = line.toUtf8();
+    return process_line(utf8.constData(), utf8.size(), filename, line_number, error_ptr);
+}
+
+bool SimpleAsm::process_line(
+    const char *line,
+    int length,
+    const QString &filename,
+    int line_number,
+    QString *error_ptr) {
+    if (incremental == nullptr) {
+        return assemble_line(line, length, filename, line_number, error_ptr);
+    }
+
+    QByteArray key(int(sizeof(uint64_t)) + length, Qt::Uninitialized);
+    const uint64_t start = address.get_raw();
+    memcpy(key.data(), &start, sizeof(start));
+    memcpy(key.data() + sizeof(start), line, length);
+
+    std::shared_ptr<SimpleAsmIncrementalState::Line> record = incremental->lines.value(key);
+    if (record != nullptr) {
+        // Same text at the same address, reuse the previous output.
+        for (SimpleAsmIncrementalState::Reloc &r : record->relocs) {
+            r.expression.filename = filename;
+            r.expression.line = line_number;
+        }
+        if (!record->label.isEmpty()) { define_symbol(record->label, start, 4); }
+        address += record->bytes.size();
+        lines.push_back(record);
+        next_lines.insert(key, record);
+        return true;
+    }
+
+    record = std::make_shared<SimpleAsmIncrementalState::Line>();
+    record->start = address;
+    SimpleAsmIncrementalState::Line *const outer_line = current_line;
+    const int reloc_count = reloc.size();
+    current_line = record.get();
+    const bool ok = assemble_line(line, length, filename, line_number, error_ptr);
+    current_line = outer_line;
+    for (int i = reloc_count; i < reloc.size(); i++) {
+        record->relocs.push_back({ *reloc.at(i), {}, false });
+        delete reloc.at(i);
+    }
+    reloc.resize(reloc_count);
+    lines.push_back(record);
+    if (ok && record->cacheable) { next_lines.insert(key, record); }
+    return ok;
+}
+
+bool SimpleAsm::assemble_line(
+    const char *line,
+    int length,
+    const QString &filename,
+    int line_number,
+    QString *error_ptr) {
     QString error;
     QString label = "";
     QString op = "";
@@ -100,16 +269,18 @@ bool SimpleAsm::process_line(
     int token_last = -1;
     int operand_num = -1;
 
-    for (pos = 0; pos <= line.count(); pos++) {
-        QChar ch = ' ';
-        if (pos >= line.count()) { final = true; }
-        if (!final) { ch = line.at(pos); }
+    // Single pass over UTF-8 bytes. All syntax characters are ASCII, multibyte characters can
+    // appear only inside tokens, which are converted to strings at once.
+    for (pos = 0; pos <= length; pos++) {
+        char ch = ' ';
+        if (pos >= length) { final = true; }
+        if (!final) { ch = line[pos]; }
         if (!in_quotes) {
             if (ch == '#') {
-                if (line.mid(pos).startsWith("#include")) {
-                    if ((line.count() > pos + 8) && !line.at(pos + 8).isSpace()) { final = true; }
-                } else if (line.mid(pos).startsWith("#pragma")) {
-                    if ((line.count() > pos + 7) && !line.at(pos + 7).isSpace()) {
+                if (starts_with(line + pos, length - pos, "#include")) {
+                    if ((length > pos + 8) && !is_space(line[pos + 8])) { final = true; }
+                } else if (starts_with(line + pos, length - pos, "#pragma")) {
+                    if ((length > pos + 7) && !is_space(line[pos + 7])) {
                         final = true;
                     } else {
                         space_separated = true;
@@ -120,14 +291,14 @@ bool SimpleAsm::process_line(
             }
             if (ch == ';') { final = true; }
             if (ch == '/') {
-                if (pos + 1 < line.count()) {
-                    if (line.at(pos + 1) == '/') { final = true; }
+                if (pos + 1 < length) {
+                    if (line[pos + 1] == '/') { final = true; }
                 }
             }
             separator
                 = final || (maybe_label && (ch == ':'))
                   || ((operand_num >= 0)
-                      && ((ch == ',') || (space_separated && ch.isSpace() && (token_beg != -1))));
+                      && ((ch == ',') || (space_separated && is_space(ch) && (token_beg != -1))));
             if (maybe_label && (ch == ':')) {
                 maybe_label = false;
                 if (token_beg == -1) {
@@ -138,14 +309,14 @@ bool SimpleAsm::process_line(
                     if (error_ptr != nullptr) { *error_ptr = error; }
                     return false;
                 }
-                label = line.mid(token_beg, token_last - token_beg + 1);
+                label = QString::fromUtf8(line + token_beg, token_last - token_beg + 1);
                 token_beg = -1;
             } else if (
-                ((!ch.isSpace() && (token_beg >= 0) && (token_last < pos - 1)) || final)
+                ((!is_space(ch) && (token_beg >= 0) && (token_last < pos - 1)) || final)
                 && (operand_num == -1)) {
                 maybe_label = false;
                 if (token_beg != -1) {
-                    op = line.mid(token_beg, token_last - token_beg + 1).toLower();
+                    op = QString::fromUtf8(line + token_beg, token_last - token_beg + 1).toLower();
                 }
                 token_beg = -1;
                 operand_num = 0;
@@ -166,12 +337,12 @@ bool SimpleAsm::process_line(
                     if (error_ptr != nullptr) { *error_ptr = error; }
                     return false;
                 }
-                operands.append(line.mid(token_beg, token_last - token_beg + 1));
+                operands.append(QString::fromUtf8(line + token_beg, token_last - token_beg + 1));
                 token_beg = -1;
                 operand_num++;
             }
             if (final) { break; }
-            if (!ch.isSpace() && !separator) {
+            if (!is_space(ch) && !separator) {
                 if (token_beg == -1) { token_beg = pos; }
                 token_last = pos;
             }
@@ -205,7 +376,10 @@ bool SimpleAsm::process_line(
         }
     }
 
-    if (!label.isEmpty()) { symtab->setSymbol(label, address.get_raw(), 4); }
+    if (!label.isEmpty()) {
+        define_symbol(label, address.get_raw(), 4);
+        if (current_line != nullptr) { current_line->label = label; }
+    }
 
     if (op.isEmpty()) {
         if (operands.count() != 0) {
@@ -218,8 +392,12 @@ bool SimpleAsm::process_line(
         return true;
     }
 
-    if (op == "#pragma") { return process_pragma(operands, filename, line_number, error_ptr); }
+    if (op == "#pragma") {
+        mark_uncacheable();
+        return process_pragma(operands, filename, line_number, error_ptr);
+    }
     if (op == "#include") {
+        mark_uncacheable();
         bool res = true;
         QString incname;
         if ((operands.count() != 1) || operands.at(0).isEmpty()) {
@@ -258,6 +436,7 @@ bool SimpleAsm::process_line(
         return true;
     }
     if (op == ".org") {
+        mark_uncacheable();
         bool ok;
         fixmatheval::FmeExpression expression;
         fixmatheval::FmeValue value;
@@ -271,7 +450,7 @@ bool SimpleAsm::process_line(
         ok = expression.parse(operands.at(0), error);
         if (!ok) {
             fatal_occured = true;
-            error = tr(".orig %1 parse error.").arg(line);
+            error = tr(".orig %1 parse error.").arg(QString::fromUtf8(line, length));
             emit report_message(messagetype::MSG_ERROR, filename, line_number, 0, error, "");
             error_occured = true;
             if (error_ptr != nullptr) { *error_ptr = error; }
@@ -280,7 +459,7 @@ bool SimpleAsm::process_line(
         ok = expression.eval(value, symtab, error, address);
         if (!ok) {
             fatal_occured = true;
-            error = tr(".orig %1 evaluation error.").arg(line);
+            error = tr(".orig %1 evaluation error.").arg(QString::fromUtf8(line, length));
             emit report_message(messagetype::MSG_ERROR, filename, line_number, 0, error, "");
             error_occured = true;
             if (error_ptr != nullptr) { *error_ptr = error; }
@@ -290,6 +469,7 @@ bool SimpleAsm::process_line(
         return true;
     }
     if ((op == ".space") || (op == ".skip")) {
+        mark_uncacheable();
         bool ok;
         fixmatheval::FmeExpression expression;
         fixmatheval::FmeValue value;
@@ -305,7 +485,7 @@ bool SimpleAsm::process_line(
             ok = expression.parse(operands.at(1), error);
             if (!ok) {
                 fatal_occured = true;
-                error = tr(".space/.skip %1 parse error.").arg(line);
+                error = tr(".space/.skip %1 parse error.").arg(QString::fromUtf8(line, length));
                 emit report_message(messagetype::MSG_ERROR, filename, line_number, 0, error, "");
                 error_occured = true;
                 if (error_ptr != nullptr) { *error_ptr = error; }
@@ -314,7 +494,8 @@ bool SimpleAsm::process_line(
             ok = expression.eval(fill, symtab, error, address);
             if (!ok) {
                 fatal_occured = true;
-                error = tr(".space/.skip %1 evaluation error.").arg(line);
+                error = tr(".space/.skip %1 evaluation error.")
+                            .arg(QString::fromUtf8(line, length));
                 emit report_message(messagetype::MSG_ERROR, filename, line_number, 0, error, "");
                 error_occured = true;
                 if (error_ptr != nullptr) { *error_ptr = error; }
@@ -324,7 +505,7 @@ bool SimpleAsm::process_line(
         ok = expression.parse(operands.at(0), error);
         if (!ok) {
             fatal_occured = true;
-            error = tr(".space/.skip %1 parse error.").arg(line);
+            error = tr(".space/.skip %1 parse error.").arg(QString::fromUtf8(line, length));
             emit report_message(messagetype::MSG_ERROR, filename, line_number, 0, error, "");
             error_occured = true;
             if (error_ptr != nullptr) { *error_ptr = error; }
@@ -333,19 +514,20 @@ bool SimpleAsm::process_line(
         ok = expression.eval(value, symtab, error, address);
         if (!ok) {
             fatal_occured = true;
-            error = tr(".space/.skip %1 evaluation error.").arg(line);
+            error = tr(".space/.skip %1 evaluation error.").arg(QString::fromUtf8(line, length));
             emit report_message(messagetype::MSG_ERROR, filename, line_number, 0, error, "");
             error_occured = true;
             if (error_ptr != nullptr) { *error_ptr = error; }
             return false;
         }
         while (value-- > 0) {
-            if (!fatal_occured) { mem->write_u8(address, (uint8_t)fill, ae::INTERNAL); }
+            emit_u8(address, (uint8_t)fill);
             address += 1;
         }
         return true;
     }
     if ((op == ".equ") || (op == ".set")) {
+        mark_uncacheable();
         if ((operands.count() > 2) || (operands.count() < 1)) {
             error = tr(".set or .equ incorrect arguments number.");
             emit report_message(messagetype::MSG_ERROR, filename, line_number, 0, error, "");
@@ -369,7 +551,7 @@ bool SimpleAsm::process_line(
                 return false;
             }
         }
-        symtab->setSymbol(name, value, 0);
+        define_symbol(name, value, 0);
         return true;
     }
     if ((op == ".ascii") || (op == ".asciz")) {
@@ -437,17 +619,18 @@ bool SimpleAsm::process_line(
                     target_byte = host_char.toLatin1();
                 }
 
-                if (!fatal_occured) { mem->write_u8(address, target_byte, ae::INTERNAL); }
+                emit_u8(address, target_byte);
                 address += 1;
             }
             if (append_zero) {
-                if (!fatal_occured) { mem->write_u8(address, 0, ae::INTERNAL); }
+                emit_u8(address, 0);
                 address += 1;
             }
         }
         return true;
     }
     if (op == ".byte") {
+        mark_uncacheable();
         bool ok;
         for (const QString &s : operands) {
             uint32_t val = 0;
@@ -459,7 +642,7 @@ bool SimpleAsm::process_line(
                 ok = expression.parse(s, error);
                 if (!ok) {
                     fatal_occured = true;
-                    error = tr(".byte %1 parse error.").arg(line);
+                    error = tr(".byte %1 parse error.").arg(QString::fromUtf8(line, length));
                     emit report_message(
                         messagetype::MSG_ERROR, filename, line_number, 0, error, "");
                     error_occured = true;
@@ -469,7 +652,7 @@ bool SimpleAsm::process_line(
                 ok = expression.eval(value, symtab, error, address);
                 if (!ok) {
                     fatal_occured = true;
-                    error = tr(".byte %1 evaluation error.").arg(line);
+                    error = tr(".byte %1 evaluation error.").arg(QString::fromUtf8(line, length));
                     emit report_message(
                         messagetype::MSG_ERROR, filename, line_number, 0, error, "");
                     error_occured = true;
@@ -478,14 +661,14 @@ bool SimpleAsm::process_line(
                 }
                 val = (uint8_t)value;
             }
-            if (!fatal_occured) { mem->write_u8(address, (uint8_t)val, ae::INTERNAL); }
+            emit_u8(address, (uint8_t)val);
             address += 1;
         }
         return true;
     }
 
     while (address.get_raw() & 3) {
-        if (!fatal_occured) { mem->write_u8(address, 0, ae::INTERNAL); }
+        emit_u8(address, 0);
         address += 1;
     }
 
@@ -500,7 +683,7 @@ bool SimpleAsm::process_line(
                 reloc.append(new machine::RelocExpression(
                     address, s, 0, -0xffffffff, 0xffffffff, &wordArg, filename, line_number));
             }
-            if (!fatal_occured) { mem->write_u32(address, val, ae::INTERNAL); }
+            emit_u32(address, val);
             address += 4;
         }
         return true;
@@ -513,7 +696,8 @@ bool SimpleAsm::process_line(
                                                  static_cast<unsigned>(line_number) };
         size = machine::Instruction::code_from_tokens(inst, 8, inst_tok, &reloc);
     } catch (machine::Instruction::ParseError &e) {
-        error = tr("instruction %1 parse error - %2.").arg(line, e.message);
+        error = tr("instruction %1 parse error - %2.")
+                    .arg(QString::fromUtf8(line, length), e.message);
         emit report_message(messagetype::MSG_ERROR, filename, line_number, 0, e.message, "");
         error_occured = true;
         if (error_ptr != nullptr) { *error_ptr = error; }
@@ -521,7 +705,7 @@ bool SimpleAsm::process_line(
     }
     uint32_t *p = inst;
     for (size_t l = 0; l < size; l += 4) {
-        if (!fatal_occured) { mem->write_u32(address, *(p++), ae::INTERNAL); }
+        emit_u32(address, *(p++));
         address += 4;
     }
     return true;
@@ -538,32 +722,122 @@ bool SimpleAsm::process_file(const QString &filename, QString *error_ptr) {
         if (error_ptr != nullptr) { *error_ptr = error; }
         return false;
     }
-    for (int ln = 1; !srcfile.atEnd(); ln++) {
-        QString line = srcfile.readLine();
-        if ((line.count() > 0) && (line.at(line.count() - 1) == '\n')) {
-            line.truncate(line.count() - 1);
+    // Lines are tokenized directly in the file buffer, without conversion of whole lines.
+    const QByteArray data = srcfile.readAll();
+    srcfile.close();
+    const char *line = data.constData();
+    const char *const data_end = line + data.size();
+    for (int ln = 1; line < data_end; ln++) {
+        auto *line_end = static_cast<const char *>(memchr(line, '\n', data_end - line));
+        const char *next_line = (line_end != nullptr) ? line_end + 1 : data_end;
+        if (line_end == nullptr) {
+            line_end = data_end;
+        } else if (line_end > line && line_end[-1] == '\r') {
+            line_end--; // Text mode conversion of CR LF.
         }
-        if (!process_line(line, filename, ln, error_ptr)) { res = false; }
+        if (!process_line(line, int(line_end - line), filename, ln, error_ptr)) { res = false; }
+        line = next_line;
     }
-    srcfile.close();
     return res;
 }
 
+namespace {
+/**
+ * Relocation expressions compiled against shared symbol slots. Each distinct expression is parsed
+ * and compiled once, each symbol is looked up once and the relocations are then evaluated without
+ * walking expression trees.
+ */
+class RelocBatch {
+public:
+    struct Entry {
+        std::shared_ptr<fixmatheval::FmeExpression> expression;
+        fixmatheval::FmeCode code;
+        QString parse_error;
+        bool parsed = false;
+        bool compiled = false;
+    };
+
+    /** Successfully parsed expressions are kept in the cache, when provided. */
+    explicit RelocBatch(QHash<QString, std::shared_ptr<fixmatheval::FmeExpression>> *cache)
+        : cache(cache) {}
+
+    int add(const QString &expression) {
+        auto it = index.constFind(expression);
+        if (it != index.cend()) { return it.value(); }
+        Entry entry;
+        if (cache != nullptr) { entry.expression = cache->value(expression); }
+        if (entry.expression != nullptr) {
+            entry.parsed = true;
+        } else {
+            entry.expression = std::make_shared<fixmatheval::FmeExpression>();
+            entry.parsed = entry.expression->parse(expression, entry.parse_error);
+            if (entry.parsed && cache != nullptr) { cache->insert(expression, entry.expression); }
+        }
+        if (entry.parsed) { entry.compiled = entry.expression->compile(entry.code, symbols); }
+        entries.push_back(std::move(entry));
+        index.insert(expression, int(entries.size()) - 1);
+        return int(entries.size()) - 1;
+    }
+
+    void resolve(fixmatheval::FmeSymbolDb *symdb) { symbols.resolve(symdb); }
+
+    const Entry &entry(int i) const { return entries[i]; }
+
+    bool eval(
+        int i,
+        fixmatheval::FmeValue &value,
+        QString &error,
+        Address location,
+        fixmatheval::FmeSymbolDb *symdb) {
+        Entry &e = entries[i];
+        if (e.compiled) { return e.code.eval(value, symbols, error, location); }
+        // Incomplete expressions are left to the tree evaluation to report them the same way.
+        return e.expression->eval(value, symdb, error, location);
+    }
+
+    QStringList symbol_names(int i) const {
+        QStringList names;
+        for (int slot : entries[i].code.symbol_slots()) {
+            names.append(symbols.name(slot));
+        }
+        return names;
+    }
+
+private:
+    QHash<QString, std::shared_ptr<fixmatheval::FmeExpression>> *cache;
+    QHash<QString, int> index;
+    std::vector<Entry> entries;
+    fixmatheval::FmeSymbolSlots symbols;
+};
+} // namespace
+
 bool SimpleAsm::finish(QString *error_ptr) {
+    if (incremental != nullptr) { return finish_incremental(error_ptr); }
     bool error_reported = false;
+    // Generated sources refer to the same symbols over and over, all relocations are evaluated
+    // in one batch.
+    RelocBatch batch(nullptr);
+    std::vector<int> expression_index;
+    expression_index.reserve(reloc.size());
     for (machine::RelocExpression *r : reloc) {
+        expression_index.push_back(batch.add(r->expression));
+    }
+    batch.resolve(symtab);
+    for (int i = 0; i < reloc.size(); i++) {
+        machine::RelocExpression *r = reloc.at(i);
+        const RelocBatch::Entry &entry = batch.entry(expression_index[i]);
+        fixmatheval::FmeExpression &expression = *entry.expression;
         QString error;
-        fixmatheval::FmeExpression expression;
-        if (!expression.parse(r->expression, error)) {
+        if (!entry.parsed) {
             error = tr("expression parse error %1 at line %2, expression %3.")
-                        .arg(error, QString::number(r->line), expression.dump());
+                        .arg(entry.parse_error, QString::number(r->line), expression.dump());
             emit report_message(messagetype::MSG_ERROR, r->filename, r->line, 0, error, "");
             if (error_ptr != nullptr && !error_reported) { *error_ptr = error; }
             error_occured = true;
             error_reported = true;
         } else {
             fixmatheval::FmeValue value;
-            if (!expression.eval(value, symtab, error, r->location)) {
+            if (!batch.eval(expression_index[i], value, error, r->location, symtab)) {
                 error = tr("expression evalution error %1 at line %2 , "
                            "expression %3.")
                             .arg(error, QString::number(r->line), expression.dump());
@@ -592,6 +866,7 @@ bool SimpleAsm::finish(QString *error_ptr) {
                 }
                 if (!fatal_occured) {
                     mem->write_u32(Address(r->location), inst.data(), ae::INTERNAL);
+                    note_written(r->location, 4);
                 }
             }
         }
@@ -600,7 +875,121 @@ bool SimpleAsm::finish(QString *error_ptr) {
         delete reloc.takeFirst();
     }
 
-    emit mem->external_change_notify(mem, Address::null(), Address(0xffffffff), ae::INTERNAL);
+    if (written) {
+        emit mem->external_change_notify(mem, written_start, written_last, ae::INTERNAL);
+    }
+
+    return !error_occured;
+}
+
+bool SimpleAsm::finish_incremental(QString *error_ptr) {
+    bool error_reported = false;
+    // Relocations of reused lines are evaluated again only when some of their symbols changed.
+    QSet<QString> changed_symbols;
+    for (auto it = defined_symbols.cbegin(); it != defined_symbols.cend(); ++it) {
+        auto previous = incremental->symbols.constFind(it.key());
+        if (previous == incremental->symbols.cend() || previous.value() != it.value()) {
+            changed_symbols.insert(it.key());
+        }
+    }
+    for (auto it = incremental->symbols.cbegin(); it != incremental->symbols.cend(); ++it) {
+        if (!defined_symbols.contains(it.key())) { changed_symbols.insert(it.key()); }
+    }
+
+    struct Pending {
+        SimpleAsmIncrementalState::Line *line;
+        SimpleAsmIncrementalState::Reloc *reloc;
+        int expression;
+    };
+    std::vector<Pending> pending;
+    RelocBatch batch(&incremental->expressions);
+    for (const std::shared_ptr<SimpleAsmIncrementalState::Line> &record : lines) {
+        for (SimpleAsmIncrementalState::Reloc &rel : record->relocs) {
+            if (rel.resolved) {
+                bool changed = false;
+                for (const QString &name : rel.symbols) {
+                    if (changed_symbols.contains(name)) {
+                        changed = true;
+                        break;
+                    }
+                }
+                if (!changed) { continue; }
+            }
+            pending.push_back({ record.get(), &rel, batch.add(rel.expression.expression) });
+        }
+    }
+    batch.resolve(symtab);
+
+    const bool swap = mem->simulated_machine_endian != NATIVE_ENDIAN;
+    for (const Pending &p : pending) {
+        SimpleAsmIncrementalState::Reloc &rel = *p.reloc;
+        machine::RelocExpression *r = &rel.expression;
+        const RelocBatch::Entry &entry = batch.entry(p.expression);
+        fixmatheval::FmeExpression &expression = *entry.expression;
+        QString error;
+        rel.resolved = false;
+        rel.symbols.clear();
+        if (!entry.parsed) {
+            error = tr("expression parse error %1 at line %2, expression %3.")
+                        .arg(entry.parse_error, QString::number(r->line), expression.dump());
+            emit report_message(messagetype::MSG_ERROR, r->filename, r->line, 0, error, "");
+            if (error_ptr != nullptr && !error_reported) { *error_ptr = error; }
+            error_occured = true;
+            error_reported = true;
+            continue;
+        }
+        fixmatheval::FmeValue value;
+        if (!batch.eval(p.expression, value, error, r->location, symtab)) {
+            error = tr("expression evalution error %1 at line %2 , "
+                       "expression %3.")
+                        .arg(error, QString::number(r->line), expression.dump());
+            emit report_message(messagetype::MSG_ERROR, r->filename, r->line, 0, error, "");
+            if (error_ptr != nullptr && !error_reported) { *error_ptr = error; }
+            error_occured = true;
+            error_reported = true;
+            continue;
+        }
+        const int64_t offset = r->location - p.line->start;
+        if (offset < 0 || offset + 4 > p.line->bytes.size()) { continue; }
+        char *word = p.line->bytes.data() + offset;
+        uint32_t code;
+        memcpy(&code, word, sizeof(code));
+        machine::Instruction inst(byteswap_if(code, swap));
+        if (inst.update(value, r)) {
+            rel.resolved = true;
+            rel.symbols = batch.symbol_names(p.expression);
+        } else {
+            error = tr("instruction update error %1 at line %2, "
+                       "expression %3 -> value %4.")
+                        .arg(
+                            error, QString::number(r->line), expression.dump(),
+                            QString::number(value));
+            emit report_message(messagetype::MSG_ERROR, r->filename, r->line, 0, error, "");
+            if (error_ptr != nullptr && !error_reported) { *error_ptr = error; }
+            error_occured = true;
+            error_reported = true;
+        }
+        code = byteswap_if(inst.data(), swap);
+        memcpy(word, &code, sizeof(code));
+    }
+
+    // Only the words, which differ from the memory content, are written. This also covers memory
+    // reset or modified by the program since the last compilation.
+    if (!fatal_occured) {
+        for (const std::shared_ptr<SimpleAsmIncrementalState::Line> &record : lines) {
+            write_changed(record->start, record->bytes);
+        }
+    }
+
+    incremental->lines = std::move(next_lines);
+    incremental->symbols = std::move(defined_symbols);
+    next_lines.clear();
+    defined_symbols.clear();
+    lines.clear();
+
+    if (written) {
+        emit mem->external_change_notify(mem, written_start, written_last, ae::INTERNAL);
+    }
 
     return !error_occured;
 }
@@ -6,8 +6,11 @@
 #include "machine/memory/frontend_memory.h"
 #include "messagetype.h"
 
+#include <QHash>
 #include <QString>
 #include <QStringList>
+#include <memory>
+#include <vector>
 
 using machine::SymbolInfo;
 using machine::SymbolOther;
@@ -29,6 +32,47 @@ private:
     machine::SymbolTable *symbol_table;
 };
 
+/**
+ * Assembled lines of a source kept between compilations by `SimpleAsm` in incremental mode.
+ *
+ * Lines, which have not changed and are placed at the same address, are neither parsed nor
+ * encoded again. Their relocations are evaluated again only when a symbol they reference has
+ * changed and only words, which differ from the current memory content, are written.
+ */
+class SimpleAsmIncrementalState {
+public:
+    /** Forget all kept lines, next compilation will assemble the whole source. */
+    void clear();
+
+    struct Reloc {
+        machine::RelocExpression expression;
+        /** Symbols used by the last successful evaluation. */
+        QStringList symbols;
+        bool resolved = false;
+    };
+
+    struct Line {
+        machine::Address start;
+        /** Emitted bytes in the simulated machine endianness, relocations applied. */
+        QByteArray bytes;
+        QString label;
+        std::vector<Reloc> relocs;
+        /** Output depends on symbols defined before the line, it cannot be reused. */
+        bool cacheable = true;
+    };
+
+private:
+    friend class SimpleAsm;
+
+    bool valid = false;
+    machine::Xlen xlen {};
+    /** Lines of the last compilation indexed by address and text of the line. */
+    QHash<QByteArray, std::shared_ptr<Line>> lines;
+    /** Symbols defined by the last compilation. */
+    QHash<QString, fixmatheval::FmeValue> symbols;
+    QHash<QString, std::shared_ptr<fixmatheval::FmeExpression>> expressions;
+};
+
 class SimpleAsm : public QObject {
     Q_OBJECT
 
@@ -55,12 +99,23 @@ public:
         machine::FrontendMemory *mem,
         SymbolTableDb *symtab,
         machine::Address address,
-        machine::Xlen xlen);
+        machine::Xlen xlen,
+        SimpleAsmIncrementalState *incremental = nullptr);
     bool process_line(
         const QString &line,
         const QString &filename = "",
         int line_number = 0,
         QString *error_ptr = nullptr);
+    /**
+     * Same as above for a line in UTF-8 (not necessarily zero terminated), which avoids
+     * conversion of the whole line to a string.
+     */
+    bool process_line(
+        const char *line,
+        int length,
+        const QString &filename = "",
+        int line_number = 0,
+        QString *error_ptr = nullptr);
     virtual bool
     process_file(const QString &filename, QString *error_ptr = nullptr);
     bool finish(QString *error_ptr = nullptr);
@@ -77,9 +132,33 @@ protected:
     machine::Address address {};
 
 private:
+    void define_symbol(const QString &name, SymbolValue value, SymbolSize size);
+    void mark_uncacheable();
+    void emit_u8(machine::Address location, uint8_t value);
+    void emit_u32(machine::Address location, uint32_t value);
+    void note_written(machine::Address location, size_t size);
+    void write_changed(machine::Address start, const QByteArray &bytes);
+    bool assemble_line(
+        const char *line,
+        int length,
+        const QString &filename,
+        int line_number,
+        QString *error_ptr);
+    bool finish_incremental(QString *error_ptr);
+
     QStringList include_stack;
     machine::FrontendMemory *mem {};
     machine::RelocExpressionList reloc;
+    machine::Address written_start {};
+    machine::Address written_last {};
+    bool written = false;
+
+    SimpleAsmIncrementalState *incremental {};
+    /** Lines of the current compilation in source order (incremental mode only). */
+    std::vector<std::shared_ptr<SimpleAsmIncrementalState::Line>> lines;
+    QHash<QByteArray, std::shared_ptr<SimpleAsmIncrementalState::Line>> next_lines;
+    QHash<QString, fixmatheval::FmeValue> defined_symbols;
+    SimpleAsmIncrementalState::Line *current_line {};
 };
 
 #endif /*SIMPLEASM_H*/
@@ -0,0 +1,212 @@
+#include "simpleasm.test.h"
+
+#include "assembler/simpleasm.h"
+#include "machine/memory/backend/memory.h"
+#include "machine/memory/memory_bus.h"
+#include "machine/symboltable.h"
+
+#include <QTemporaryFile>
+
+using namespace machine;
+
+constexpr Address PROGRAM_START = 0x200_addr;
+
+static const char *const TEST_PROGRAM[] = {
+    "start:  addi x1, x0, 5   # comment",
+    "        lw x2, 4(x1) ; another comment",
+    "        beq x1, x2, start // and another",
+    "#pragma qtrvsim ignored",
+    "        .word start, end",
+    "        .asciz \"a,b\\\"c\"",
+    "end:",
+};
+
+static void check_test_program(FrontendMemory &mem, SymbolTable &symtab) {
+    QCOMPARE(mem.read_u32(PROGRAM_START), uint32_t(0x00500093));
+    QCOMPARE(mem.read_u32(PROGRAM_START + 4), uint32_t(0x0040a103));
+    QCOMPARE(mem.read_u32(PROGRAM_START + 8), uint32_t(0xfe208ce3));
+    QCOMPARE(mem.read_u32(PROGRAM_START + 12), uint32_t(0x200));
+    QCOMPARE(mem.read_u32(PROGRAM_START + 16), uint32_t(0x21a));
+    const char expected[] = "a,b\"c";
+    for (size_t i = 0; i < sizeof(expected); i++) {
+        QCOMPARE(mem.read_u8(PROGRAM_START + 20 + i), uint8_t(expected[i]));
+    }
+    SymbolValue end = 0;
+    QVERIFY(symtab.name_to_value(end, "end"));
+    QCOMPARE(end, SymbolValue(0x21a));
+}
+
+void TestSimpleAsm::simpleasm_lines() {
+    Memory memory(LITTLE);
+    TrivialBus mem(&memory);
+    SymbolTable symtab;
+    SymbolTableDb symtab_db(&symtab);
+    SimpleAsm sasm;
+    sasm.setup(&mem, &symtab_db, PROGRAM_START, Xlen::_32);
+    int ln = 1;
+    for (const char *line : TEST_PROGRAM) {
+        QVERIFY(sasm.process_line(QString(line), "test.S", ln++));
+    }
+    QVERIFY(sasm.finish());
+    check_test_program(mem, symtab);
+
+    QString error;
+    QVERIFY(!sasm.process_line(QString("addi x1, x0"), "test.S", ln++, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!sasm.process_line(QString(".asciz \"unterminated"), "test.S", ln++));
+}
+
+void TestSimpleAsm::simpleasm_file() {
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    for (const char *line : TEST_PROGRAM) {
+        file.write(line);
+        file.write("\r\n");
+    }
+    file.close();
+
+    Memory memory(LITTLE);
+    TrivialBus mem(&memory);
+    SymbolTable symtab;
+    SymbolTableDb symtab_db(&symtab);
+    SimpleAsm sasm;
+    sasm.setup(&mem, &symtab_db, PROGRAM_START, Xlen::_32);
+    QVERIFY(sasm.process_file(file.fileName()));
+    QVERIFY(sasm.finish());
+    check_test_program(mem, symtab);
+}
+
+static bool assemble_lines(
+    FrontendMemory &mem,
+    SymbolTable &symtab,
+    const QStringList &lines,
+    SimpleAsmIncrementalState *state) {
+    SymbolTableDb symtab_db(&symtab);
+    SimpleAsm sasm;
+    sasm.setup(&mem, &symtab_db, PROGRAM_START, Xlen::_32, state);
+    bool ok = true;
+    int ln = 1;
+    for (const QString &line : lines) {
+        ok &= sasm.process_line(line, "test.S", ln++);
+    }
+    return sasm.finish() && ok;
+}
+
+void TestSimpleAsm::simpleasm_incremental() {
+    Memory memory(LITTLE);
+    TrivialBus mem(&memory);
+    SymbolTable symtab;
+    SimpleAsmIncrementalState state;
+    int notify_count = 0;
+    Address changed_start, changed_last;
+    QObject::connect(
+        &mem, &FrontendMemory::external_change_notify,
+        [&](const FrontendMemory *, Address start_addr, Address last_addr, AccessEffects) {
+            notify_count++;
+            changed_start = start_addr;
+            changed_last = last_addr;
+        });
+    QStringList lines;
+    for (const char *line : TEST_PROGRAM) {
+        lines.append(line);
+    }
+    QVERIFY(assemble_lines(mem, symtab, lines, &state));
+    check_test_program(mem, symtab);
+
+    // Nothing changed, nothing is written.
+    notify_count = 0;
+    QVERIFY(assemble_lines(mem, symtab, lines, &state));
+    QCOMPARE(notify_count, 0);
+    check_test_program(mem, symtab);
+
+    // Single instruction changed.
+    lines[0] = "start:  addi x1, x0, 6";
+    QVERIFY(assemble_lines(mem, symtab, lines, &state));
+    QCOMPARE(notify_count, 1);
+    QCOMPARE(changed_start.get_raw(), PROGRAM_START.get_raw());
+    QCOMPARE(changed_last.get_raw(), (PROGRAM_START + 3).get_raw());
+    QCOMPARE(mem.read_u32(PROGRAM_START), uint32_t(0x00600093));
+
+    // Inserted instruction moves the following lines and the symbol referenced by .word.
+    lines.insert(3, "        nop");
+    QVERIFY(assemble_lines(mem, symtab, lines, &state));
+    Memory expected_memory(LITTLE);
+    TrivialBus expected_mem(&expected_memory);
+    SymbolTable expected_symtab;
+    QVERIFY(assemble_lines(expected_mem, expected_symtab, lines, nullptr));
+    for (Address addr = PROGRAM_START; addr < PROGRAM_START + 0x20; addr += 4) {
+        QCOMPARE(mem.read_u32(addr), expected_mem.read_u32(addr));
+    }
+    QCOMPARE(mem.read_u32(PROGRAM_START + 20), uint32_t(0x21e));
+
+    // Memory content lost (e.g. by machine reset) is restored.
+    memory.reset();
+    QVERIFY(assemble_lines(mem, symtab, lines, &state));
+    for (Address addr = PROGRAM_START; addr < PROGRAM_START + 0x20; addr += 4) {
+        QCOMPARE(mem.read_u32(addr), expected_mem.read_u32(addr));
+    }
+}
+
+void TestSimpleAsm::simpleasm_expressions() {
+    Memory memory(LITTLE);
+    TrivialBus mem(&memory);
+    SymbolTable symtab;
+    const QStringList lines = {
+        "start:  .word (end - start) * 2",
+        "        .word 3 * 4 + 1",
+        "        .word -(2 + 3) & 0xff",
+        "        .word %hi(start + 0x1000) + %lo(end)",
+        "        addi x1, x0, %pcrel_lo(end)",
+        "end:",
+    };
+    QVERIFY(assemble_lines(mem, symtab, lines, nullptr));
+    QCOMPARE(mem.read_u32(PROGRAM_START), uint32_t(0x28));
+    QCOMPARE(mem.read_u32(PROGRAM_START + 4), uint32_t(13));
+    QCOMPARE(mem.read_u32(PROGRAM_START + 8), uint32_t(0xfb));
+    QCOMPARE(mem.read_u32(PROGRAM_START + 12), uint32_t(0x1 + 0x214));
+    // end - (addi address) + 4
+    QCOMPARE(mem.read_u32(PROGRAM_START + 16), uint32_t(0x00800093));
+
+    SymbolTable failing_symtab;
+    QVERIFY(!assemble_lines(mem, failing_symtab, { ".word missing + 1" }, nullptr));
+}
+
+/**
+ * Machine generated like source with many labels and references to them.
+ */
+void TestSimpleAsm::simpleasm_large_source() {
+    constexpr int BLOCKS = 4096;
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    for (int block = 0; block < BLOCKS; block++) {
+        const QByteArray label = "block_" + QByteArray::number(block);
+        const QByteArray next = "block_" + QByteArray::number((block + 1) % BLOCKS);
+        file.write(label + ":\n");
+        file.write("    addi a0, a0, " + QByteArray::number(block % 2048) + " # counter\n");
+        file.write("    lw t0, 8(sp)\n");
+        file.write("    sw t0, 12(sp)\n");
+        file.write("    add t1, t0, a0\n");
+        file.write("    xori t2, t1, 0x55\n");
+        file.write("    slli t3, t2, 3\n");
+        file.write("    li t4, " + QByteArray::number(block * 4099) + "\n");
+        file.write("    la t5, " + next + "\n");
+        file.write("    beq t0, t1, " + next + "\n");
+        file.write("    bne t2, zero, " + label + "\n");
+        file.write("    jal ra, " + next + "\n");
+        file.write("    .word " + label + " + 4\n");
+    }
+    file.close();
+
+    QBENCHMARK {
+        Memory memory(LITTLE);
+        TrivialBus mem(&memory);
+        SymbolTable symtab;
+        SymbolTableDb symtab_db(&symtab);
+        SimpleAsm sasm;
+        sasm.setup(&mem, &symtab_db, PROGRAM_START, Xlen::_32);
+        QVERIFY(sasm.process_file(file.fileName()));
+        QVERIFY(sasm.finish());
+    }
+}
+
+QTEST_GUILESS_MAIN(TestSimpleAsm)
@@ -0,0 +1,17 @@
+#ifndef SIMPLEASM_TEST_H
+#define SIMPLEASM_TEST_H
+
+#include <QtTest>
+
+class TestSimpleAsm : public QObject {
+    Q_OBJECT
+
+private slots:
+    static void simpleasm_lines();
+    static void simpleasm_file();
+    static void simpleasm_incremental();
+    static void simpleasm_expressions();
+    static void simpleasm_large_source();
+};
+
+#endif // SIMPLEASM_TEST_H
@@ -1,5 +1,7 @@
 #include "chariohandler.h"
 
+#include <QCoreApplication>
+
 CharIOHandler::CharIOHandler(QIODevice *iodev, QObject *parent)
     : QIODevice(parent)
     , fd_list() {
@@ -26,12 +28,19 @@ CharIOHandler::CharIOHandler(QIODevice *iodev, QObject *parent)
 }
 
 CharIOHandler::~CharIOHandler() {
+    flushBuffer();
     if (iodev->parent() == this)
         delete iodev;
 }
 
 void CharIOHandler::writeByte(unsigned int data) {
     char ch = (char)data;
+    if (buffered) {
+        tx_buffer.append(ch);
+        if (tx_buffer.size() >= TX_FLUSH_THRESHOLD)
+            flushBuffer();
+        return;
+    }
     write(&ch, 1);
 }
 
@@ -40,10 +49,33 @@ void CharIOHandler::writeByte(int fd, unsigned int data) {
         writeByte(data);
 }
 
+void CharIOHandler::writeBytes(int fd, const QByteArray &data) {
+    if (!fd_specific || fd_list.contains(fd)) {
+        if (buffered) {
+            tx_buffer.append(data);
+            if (tx_buffer.size() >= TX_FLUSH_THRESHOLD)
+                flushBuffer();
+            return;
+        }
+        write(data);
+    }
+}
+
 void CharIOHandler::readBytePoll(int fd, unsigned int &data, bool &available) {
     char ch;
     qint64 res;
     if (!fd_specific || fd_list.contains(fd)) {
+        if (buffered) {
+            if (rx_pos >= rx_buffer.size()) {
+                rx_buffer = read(RX_READAHEAD);
+                rx_pos = 0;
+            }
+            if (rx_pos < rx_buffer.size()) {
+                data = rx_buffer.at(rx_pos++) & 0xff;
+                available = true;
+            }
+            return;
+        }
         if (bytesAvailable() > 0) {
             res = read(&ch, 1);
             if (res > 0) {
@@ -54,6 +86,24 @@ void CharIOHandler::readBytePoll(int fd, unsigned int &data, bool &available) {
     }
 }
 
+void CharIOHandler::flushBuffer() {
+    if (tx_buffer.isEmpty())
+        return;
+    write(tx_buffer);
+    tx_buffer.clear();
+}
+
+void CharIOHandler::setBuffered(bool enable) {
+    if (!enable)
+        flushBuffer();
+    if (enable && QCoreApplication::instance() != nullptr) {
+        connect(
+            QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this,
+            &CharIOHandler::flushBuffer, Qt::UniqueConnection);
+    }
+    buffered = enable;
+}
+
 void CharIOHandler::insertFd(const int &fd) {
     fd_list.insert(fd);
 }
@@ -75,6 +125,7 @@ bool CharIOHandler::open(OpenMode mode) {
 }
 
 void CharIOHandler::close() {
+    flushBuffer();
     Super::close();
     iodev->close();
 }
@@ -100,7 +151,7 @@ bool CharIOHandler::reset() {
 }
 
 qint64 CharIOHandler::bytesAvailable() const {
-    return iodev->bytesAvailable() + Super::bytesAvailable();
+    return iodev->bytesAvailable() + Super::bytesAvailable() + (rx_buffer.size() - rx_pos);
 }
 
 qint64 CharIOHandler::bytesToWrite() const {
@@ -1,6 +1,7 @@
 #ifndef CHARIOHANDLER_H
 #define CHARIOHANDLER_H
 
+#include <QByteArray>
 #include <QIODevice>
 #include <QObject>
 #include <QSet>
@@ -17,11 +18,21 @@ public:
 public slots:
     void writeByte(unsigned int data);
     void writeByte(int fd, unsigned int data);
+    void writeBytes(int fd, const QByteArray &data);
     void readBytePoll(int fd, unsigned int &data, bool &available);
+    /** Pass all buffered output to the underlying device. */
+    void flushBuffer();
 
 public:
     void insertFd(const int &fd);
     void removeFd(const int &fd);
+    /**
+     * In buffered mode, written bytes are collected and passed to the device in large blocks
+     * (on threshold, flushBuffer, close or when the application is about to quit) and input is
+     * read ahead in large blocks.
+     * The sequence of bytes seen on either side is not changed.
+     */
+    void setBuffered(bool enable);
 
     [[nodiscard]] bool isSequential() const override;
     bool open(OpenMode mode) override;
@@ -46,6 +57,13 @@ private:
     QIODevice *iodev;
     bool fd_specific;
     QSet<int> fd_list;
+    bool buffered = false;
+    QByteArray tx_buffer;
+    QByteArray rx_buffer;
+    int rx_pos = 0;
+
+    static constexpr int TX_FLUSH_THRESHOLD = 64 * 1024;
+    static constexpr int RX_READAHEAD = 64 * 1024;
 };
 
 #endif // CHARIOHANDLER_H
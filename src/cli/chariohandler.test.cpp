@@ -0,0 +1,73 @@
+#include "chariohandler.test.h"
+
+#include "chariohandler.h"
+
+#include <QBuffer>
+
+void TestCharIOHandler::chariohandler_unbuffered() {
+    QByteArray output;
+    // The handler takes ownership of the device.
+    CharIOHandler handler(new QBuffer(&output));
+    QVERIFY(handler.open(QIODevice::WriteOnly));
+    handler.writeByte('a');
+    handler.writeBytes(1, "bc");
+    QCOMPARE(output, QByteArray("abc"));
+}
+
+void TestCharIOHandler::chariohandler_buffered_write() {
+    QByteArray output;
+    CharIOHandler handler(new QBuffer(&output));
+    QVERIFY(handler.open(QIODevice::WriteOnly));
+    handler.setBuffered(true);
+    handler.writeByte('a');
+    handler.writeBytes(1, "bc");
+    QCOMPARE(output, QByteArray());
+    handler.flushBuffer();
+    QCOMPARE(output, QByteArray("abc"));
+
+    // Large output is passed on without explicit flush.
+    const QByteArray large(128 * 1024, 'x');
+    handler.writeBytes(1, large);
+    QCOMPARE(output, QByteArray("abc") + large);
+
+    // Disabling buffering and closing flush pending bytes.
+    handler.writeByte('d');
+    handler.setBuffered(false);
+    QCOMPARE(output, QByteArray("abc") + large + "d");
+    handler.setBuffered(true);
+    handler.writeByte('e');
+    handler.close();
+    QCOMPARE(output, QByteArray("abc") + large + "de");
+}
+
+void TestCharIOHandler::chariohandler_buffered_quit() {
+    QByteArray output;
+    CharIOHandler handler(new QBuffer(&output));
+    QVERIFY(handler.open(QIODevice::WriteOnly));
+    handler.setBuffered(true);
+    handler.writeBytes(1, "tail");
+    QCOMPARE(output, QByteArray());
+    // Emitted by QCoreApplication::exec before it returns.
+    QVERIFY(QMetaObject::invokeMethod(QCoreApplication::instance(), "aboutToQuit"));
+    QCOMPARE(output, QByteArray("tail"));
+}
+
+void TestCharIOHandler::chariohandler_buffered_read() {
+    QByteArray input("xyz");
+    CharIOHandler handler(new QBuffer(&input));
+    QVERIFY(handler.open(QIODevice::ReadOnly));
+    handler.setBuffered(true);
+
+    QByteArray received;
+    for (;;) {
+        unsigned data = 0;
+        bool available = false;
+        handler.readBytePoll(0, data, available);
+        if (!available) { break; }
+        received.append(char(data));
+    }
+    QCOMPARE(received, input);
+    QCOMPARE(handler.bytesAvailable(), qint64(0));
+}
+
+QTEST_GUILESS_MAIN(TestCharIOHandler)
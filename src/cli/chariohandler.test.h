@@ -0,0 +1,16 @@
+#ifndef CHARIOHANDLER_TEST_H
+#define CHARIOHANDLER_TEST_H
+
+#include <QtTest>
+
+class TestCharIOHandler : public QObject {
+    Q_OBJECT
+
+private slots:
+    static void chariohandler_unbuffered();
+    static void chariohandler_buffered_write();
+    static void chariohandler_buffered_quit();
+    static void chariohandler_buffered_read();
+};
+
+#endif // CHARIOHANDLER_TEST_H
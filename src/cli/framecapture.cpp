@@ -0,0 +1,192 @@
+#include "framecapture.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThreadPool>
+#include <array>
+#include <cstring>
+
+using namespace machine;
+
+namespace {
+
+class FrameWriter final : public QRunnable {
+public:
+    FrameWriter(QByteArray fb, size_t width, size_t height, size_t line_size, QString path)
+        : fb(std::move(fb))
+        , width(width)
+        , height(height)
+        , line_size(line_size)
+        , path(std::move(path)) {}
+
+    void run() override {
+        bool png = !path.endsWith(".ppm", Qt::CaseInsensitive);
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            fprintf(stderr, "LCD capture file %s cannot be open for write.\n", qPrintable(path));
+            return;
+        }
+        file.write(FrameCapture::encode(fb, width, height, line_size, png));
+    }
+
+private:
+    const QByteArray fb;
+    const size_t width, height, line_size;
+    const QString path;
+};
+
+uint32_t png_crc(const QByteArray &data) {
+    static const std::array<uint32_t, 256> table = []() {
+        std::array<uint32_t, 256> t {};
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xffffffffu;
+    for (char byte : data) {
+        crc = table[(crc ^ uint8_t(byte)) & 0xff] ^ (crc >> 8);
+    }
+    return crc ^ 0xffffffffu;
+}
+
+void append_be32(QByteArray &out, uint32_t value) {
+    out.append(char(value >> 24));
+    out.append(char(value >> 16));
+    out.append(char(value >> 8));
+    out.append(char(value));
+}
+
+void append_png_chunk(QByteArray &out, const char *type, const QByteArray &data) {
+    QByteArray chunk(type, 4);
+    chunk.append(data);
+    append_be32(out, data.size());
+    out.append(chunk);
+    append_be32(out, png_crc(chunk));
+}
+
+} // namespace
+
+FrameCapture::FrameCapture(Machine *machine, QString path)
+    : machine(machine)
+    , core_state(machine->core()->get_state())
+    , path(std::move(path)) {
+    connect(
+        QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this,
+        &FrameCapture::capture_exit);
+}
+
+FrameCapture::~FrameCapture() {
+    // Do not leave the process before all captured frames are written.
+    QThreadPool::globalInstance()->waitForDone();
+}
+
+void FrameCapture::set_cycle_interval(quint64 cycles) {
+    if (cycle_interval == 0 && !vsync_enabled) {
+        connect(machine->core(), &Core::step_done, this, &FrameCapture::step_done);
+    }
+    cycle_interval = cycles;
+    next_cycle_capture = cycles;
+}
+
+void FrameCapture::set_vsync_address(Address address) {
+    if (cycle_interval == 0 && !vsync_enabled) {
+        connect(machine->core(), &Core::step_done, this, &FrameCapture::step_done);
+    }
+    vsync_enabled = true;
+    vsync_address = address;
+}
+
+void FrameCapture::capture_exit() {
+    capture(path);
+}
+
+void FrameCapture::step_done() {
+    bool vsync = false;
+    if (vsync_enabled) {
+        const auto &mem = core_state.pipeline.memory.internal;
+        const auto &mem_wb = core_state.pipeline.memory.final;
+        vsync = mem.memwrite
+                && (mem_wb.mem_addr.get_raw() & ~uint64_t(3))
+                       == (vsync_address.get_raw() & ~uint64_t(3));
+    }
+    if (cycle_interval != 0 && core_state.cycle_count >= next_cycle_capture) {
+        next_cycle_capture += cycle_interval;
+        vsync = true;
+    }
+    if (vsync) { capture(frame_path(frame_index++)); }
+}
+
+void FrameCapture::capture(const QString &file_path) {
+    const LcdDisplay *lcd = machine->peripheral_lcd_display();
+    if (lcd == nullptr) { return; }
+    // Only the copy of the framebuffer is made synchronously.
+    QByteArray fb(
+        reinterpret_cast<const char *>(lcd->get_fb_data()),
+        int(lcd->get_fb_line_size() * lcd->get_height()));
+    QThreadPool::globalInstance()->start(new FrameWriter(
+        fb, lcd->get_width(), lcd->get_height(), lcd->get_fb_line_size(), file_path));
+}
+
+QString FrameCapture::frame_path(unsigned index) const {
+    QString number = QString("%1").arg(index, 5, 10, QChar('0'));
+    if (path.contains("%1")) { return path.arg(number); }
+    QFileInfo info(path);
+    QString suffix = info.suffix();
+    if (suffix.isEmpty()) { return path + "-" + number; }
+    return path.left(path.size() - suffix.size() - 1) + "-" + number + "." + suffix;
+}
+
+QByteArray FrameCapture::encode(
+    const QByteArray &fb,
+    size_t width,
+    size_t height,
+    size_t line_size,
+    bool png) {
+    // PNG scanlines are prefixed by filter type byte (0 = none).
+    const size_t prefix = png ? 1 : 0;
+    QByteArray pixels(int((width * 3 + prefix) * height), 0);
+    char *out = pixels.data();
+    for (size_t y = 0; y < height; y++) {
+        if (png) { *out++ = 0; }
+        const char *line = fb.constData() + y * line_size;
+        for (size_t x = 0; x < width; x++) {
+            uint16_t pixel;
+            memcpy(&pixel, line + x * 2, sizeof(pixel));
+            uint8_t r = (pixel >> 11u) & 0x1fu;
+            uint8_t g = (pixel >> 5u) & 0x3fu;
+            uint8_t b = (pixel >> 0u) & 0x1fu;
+            *out++ = char((r << 3u) | (r >> 2u));
+            *out++ = char((g << 2u) | (g >> 4u));
+            *out++ = char((b << 3u) | (b >> 2u));
+        }
+    }
+
+    QByteArray result;
+    if (!png) {
+        result = QString("P6\n%1 %2\n255\n").arg(width).arg(height).toLatin1();
+        result.append(pixels);
+        return result;
+    }
+
+    result.append("\x89PNG\r\n\x1a\n", 8);
+    QByteArray header;
+    append_be32(header, width);
+    append_be32(header, height);
+    header.append(char(8)); // bit depth
+    header.append(char(2)); // color type RGB
+    header.append(char(0)); // compression
+    header.append(char(0)); // filter
+    header.append(char(0)); // interlace
+    append_png_chunk(result, "IHDR", header);
+    // qCompress prepends 4 byte length to the zlib stream.
+    append_png_chunk(result, "IDAT", qCompress(pixels).mid(4));
+    append_png_chunk(result, "IEND", QByteArray());
+    return result;
+}
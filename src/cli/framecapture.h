@@ -0,0 +1,52 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include "common/memory_ownership.h"
+#include "machine/machine.h"
+#include "machine/memory/address.h"
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+
+/**
+ * Saves content of the LCD display framebuffer to image files (PNG or PPM by file suffix).
+ *
+ * Frames are captured at program exit, every given number of cycles and/or whenever the program
+ * stores to the vsync address. Image encoding and file writes run in the global thread pool so
+ * the simulation is not stalled.
+ */
+class FrameCapture final : public QObject {
+    Q_OBJECT
+public:
+    FrameCapture(machine::Machine *machine, QString path);
+    ~FrameCapture() override;
+
+    void set_cycle_interval(quint64 cycles);
+    void set_vsync_address(machine::Address address);
+
+    /** Encode RGB565 framebuffer (host endian) to PNG or PPM file content. */
+    static QByteArray
+    encode(const QByteArray &fb, size_t width, size_t height, size_t line_size, bool png);
+
+public slots:
+    void capture_exit();
+
+private slots:
+    void step_done();
+
+private:
+    void capture(const QString &path);
+    QString frame_path(unsigned index) const;
+
+    BORROWED machine::Machine *const machine;
+    const machine::CoreState &core_state;
+    const QString path;
+    quint64 cycle_interval = 0;
+    quint64 next_cycle_capture = 0;
+    bool vsync_enabled = false;
+    machine::Address vsync_address;
+    unsigned frame_index = 0;
+};
+
+#endif // FRAMECAPTURE_H
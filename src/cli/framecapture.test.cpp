@@ -0,0 +1,111 @@
+#include "framecapture.test.h"
+
+#include "framecapture.h"
+#include "machine/machine.h"
+
+#include <QTemporaryDir>
+#include <cstring>
+
+using namespace machine;
+
+/** 3x2 RGB565 framebuffer with lines padded to 8 bytes. */
+static QByteArray test_framebuffer() {
+    const uint16_t pixels[2][4] = {
+        { 0xf800, 0x07e0, 0x001f, 0xeeee }, // red, green, blue, padding
+        { 0xffff, 0x0000, 0x8410, 0xeeee }, // white, black, gray, padding
+    };
+    QByteArray fb(sizeof(pixels), 0);
+    memcpy(fb.data(), pixels, sizeof(pixels));
+    return fb;
+}
+
+/** Expected RGB888 pixels of `test_framebuffer`, low bits are replicated from the high ones. */
+static const QByteArray TEST_RGB_LINES[2] = {
+    QByteArray("\xff\x00\x00\x00\xff\x00\x00\x00\xff", 9),
+    QByteArray("\xff\xff\xff\x00\x00\x00\x84\x82\x84", 9),
+};
+
+static uint32_t read_be32(const QByteArray &data, int offset) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value = (value << 8) | uint8_t(data.at(offset + i));
+    }
+    return value;
+}
+
+/** Bitwise CRC-32 as specified by PNG, independent of the table driven encoder. */
+static uint32_t reference_crc(const QByteArray &data) {
+    uint32_t crc = 0xffffffffu;
+    for (char byte : data) {
+        crc ^= uint8_t(byte);
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+void TestFrameCapture::framecapture_ppm() {
+    const QByteArray ppm = FrameCapture::encode(test_framebuffer(), 3, 2, 8, false);
+    QCOMPARE(ppm, QByteArray("P6\n3 2\n255\n") + TEST_RGB_LINES[0] + TEST_RGB_LINES[1]);
+}
+
+void TestFrameCapture::framecapture_png() {
+    const QByteArray png = FrameCapture::encode(test_framebuffer(), 3, 2, 8, true);
+    QCOMPARE(png.left(8), QByteArray("\x89PNG\r\n\x1a\n", 8));
+
+    QStringList types;
+    QByteArray header, image_data;
+    for (int offset = 8; offset < png.size();) {
+        QVERIFY(offset + 12 <= png.size());
+        const int length = int(read_be32(png, offset));
+        QVERIFY(offset + 12 + length <= png.size());
+        // CRC covers chunk type and data.
+        const QByteArray chunk = png.mid(offset + 4, 4 + length);
+        QCOMPARE(read_be32(png, offset + 8 + length), reference_crc(chunk));
+        types.append(QString::fromLatin1(chunk.left(4)));
+        if (types.last() == "IHDR") { header = chunk.mid(4); }
+        if (types.last() == "IDAT") { image_data.append(chunk.mid(4)); }
+        if (types.last() == "IEND") { QCOMPARE(read_be32(png, offset + 8), 0xae426082u); }
+        offset += 12 + length;
+    }
+    QCOMPARE(types, QStringList({ "IHDR", "IDAT", "IEND" }));
+    // Width 3, height 2, 8 bit RGB, no interlace.
+    QCOMPARE(header, QByteArray("\0\0\0\x03\0\0\0\x02\x08\x02\0\0\0", 13));
+
+    // IDAT is a zlib stream, qUncompress expects the expected size prepended.
+    const QByteArray scanlines
+        = QByteArray(1, 0) + TEST_RGB_LINES[0] + QByteArray(1, 0) + TEST_RGB_LINES[1];
+    QByteArray size(4, 0);
+    size[3] = char(scanlines.size());
+    QCOMPARE(qUncompress(size + image_data), scanlines);
+}
+
+void TestFrameCapture::framecapture_lcd() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    Machine machine(MachineConfig(), false, false);
+    const LcdDisplay *lcd = machine.peripheral_lcd_display();
+    const size_t width = lcd->get_width(), height = lcd->get_height();
+    // First pixel red, pixel (1, 1) blue.
+    machine.memory_data_bus_rw()->write_u16(0xffe00000_addr, 0xf800, ae::INTERNAL);
+    machine.memory_data_bus_rw()->write_u16(
+        0xffe00000_addr + lcd->get_fb_line_size() + 2, 0x001f, ae::INTERNAL);
+
+    const QString path = dir.filePath("frame.ppm");
+    {
+        FrameCapture capture(&machine, path);
+        capture.capture_exit();
+        // Destructor waits for the frame to be written.
+    }
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray ppm = file.readAll();
+    const QByteArray header = QString("P6\n%1 %2\n255\n").arg(width).arg(height).toLatin1();
+    QCOMPARE(ppm.left(header.size()), header);
+    QCOMPARE(size_t(ppm.size()), header.size() + width * height * 3);
+    QCOMPARE(ppm.mid(header.size(), 6), QByteArray("\xff\x00\x00\x00\x00\x00", 6));
+    QCOMPARE(ppm.mid(int(header.size() + (width + 1) * 3), 3), QByteArray("\x00\x00\xff", 3));
+}
+
+QTEST_GUILESS_MAIN(TestFrameCapture)
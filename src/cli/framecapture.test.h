@@ -0,0 +1,15 @@
+#ifndef FRAMECAPTURE_TEST_H
+#define FRAMECAPTURE_TEST_H
+
+#include <QtTest>
+
+class TestFrameCapture : public QObject {
+    Q_OBJECT
+
+private slots:
+    static void framecapture_ppm();
+    static void framecapture_png();
+    static void framecapture_lcd();
+};
+
+#endif // FRAMECAPTURE_TEST_H
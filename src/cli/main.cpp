@@ -1,5 +1,7 @@
 #include "assembler/simpleasm.h"
 #include "chariohandler.h"
+#include "framecapture.h"
+#include "rangeio.h"
 #include "common/logging.h"
 #include "common/logging_format_colors.h"
 #include "machine/machineconfig.h"
@@ -45,6 +47,8 @@ void create_parser(QCommandLineParser &p) {
     p.addOption({ { "trace-writeback", "tr-writeback" },
                   "Trace instruction in write back stage. (only for pipelined core)" });
     p.addOption({ { "trace-pc", "tr-pc" }, "Print program counter register changes." });
+    p.addOption({ { "trace-symbols", "tr-sym" },
+                  "Annotate traced instruction addresses with containing symbol." });
     p.addOption({ { "trace-wrmem", "tr-wr" }, "Trace writes into memory." });
     p.addOption({ { "trace-rdmem", "tr-rd" }, "Trace reads from memory." });
     p.addOption({ { "trace-gp", "tr-gp" },
@@ -55,8 +59,12 @@ void create_parser(QCommandLineParser &p) {
     p.addOption({ { "dump-registers", "d-regs" }, "Dump registers state at program exit." });
     p.addOption({ "dump-cache-stats", "Dump cache statistics at program exit." });
     p.addOption({ "dump-cycles", "Dump number of CPU cycles till program end." });
-    p.addOption({ "dump-range", "Dump memory range.", "START,LENGTH,FNAME" });
-    p.addOption({ "load-range", "Load memory range.", "START,FNAME" });
+    p.addOption({ "dump-range",
+                  "Dump memory range. FNAME suffix .bin/.raw selects binary, .hex/.ihex Intel HEX, "
+                  "otherwise one word per line.",
+                  "START,LENGTH,FNAME" });
+    p.addOption({ "load-range", "Load memory range (format by suffix as in dump-range).",
+                  "START,FNAME" });
     p.addOption({ "expect-fail", "Expect that program causes CPU trap and fail if it doesn't." });
     p.addOption({ "fail-match",
                   "Program should exit with exactly this CPU TRAP. Possible values are "
@@ -82,11 +90,21 @@ void create_parser(QCommandLineParser &p) {
     p.addOption({ { "serial-in", "serin" }, "File connected to the serial port input.", "FNAME" });
     p.addOption(
         { { "serial-out", "serout" }, "File connected to the serial port output.", "FNAME" });
+    p.addOption({ "serial-buffered",
+                  "Transfer serial port files in large blocks, output is written at exit." });
     p.addOption({ { "os-emulation", "osemu" }, "Operating system emulation." });
     p.addOption({ { "std-out", "stdout" }, "File connected to the syscall standard output.", "FNAME" });
     p.addOption({ { "os-fs-root", "osfsroot" }, "Emulated system root/prefix for opened files", "DIR" });
     p.addOption({ { "isa-variant", "isavariant" }, "Instruction set to emulate (default RV32IMA)", "STR" });
     p.addOption({ "cycle-limit", "Limit execution to specified maximum clock cycles", "NUMBER" });
+    p.addOption({ "lcd-capture",
+                  "Save LCD display framebuffer to FNAME (.png or .ppm) at program exit. Periodic "
+                  "frames are numbered (%1 in FNAME or suffix before extension).",
+                  "FNAME" });
+    p.addOption({ "lcd-capture-cycles", "Save LCD frame every NUMBER cycles.", "NUMBER" });
+    p.addOption({ "lcd-capture-vsync", "Save LCD frame when program stores to ADDR.", "ADDR" });
+    p.addOption({ "idle-fast-forward",
+                  "Skip time to the next timer event when the program waits for an interrupt." });
 }
 
 void configure_cache(CacheConfig &cacheconf, const QStringList &cachearg, const QString &which) {
@@ -196,6 +214,8 @@ void configure_machine(QCommandLineParser &parser, MachineConfig &config) {
     configure_cache(*config.access_cache_program(), parser.values("i-cache"), "instruction");
     configure_cache(*config.access_cache_level2(), parser.values("l2-cache"), "level2");
 
+    config.set_idle_fast_forward(parser.isSet("idle-fast-forward"));
+
     config.set_osemu_enable(parser.isSet("os-emulation"));
     config.set_osemu_known_syscall_stop(false);
 
@@ -250,6 +270,7 @@ void configure_tracer(QCommandLineParser &p, Tracer &tr) {
     }
 
     if (p.isSet("trace-pc")) { tr.trace_pc = true; }
+    if (p.isSet("trace-symbols")) { tr.trace_symbols = true; }
     if (p.isSet("trace-gp")) { tr.trace_regs_gp = true; }
 
     QStringList gps = p.values("trace-gp");
@@ -387,6 +408,17 @@ void configure_serial_port(QCommandLineParser &p, SerialPort *ser_port) {
         }
     }
 
+    if (p.isSet("serial-buffered")) {
+        // Read ahead would move the shared position of a file used for both directions.
+        if (ser_in != nullptr && ser_in == ser_out) {
+            fprintf(
+                stderr, "Serial port buffering is not used, input and output is the same file.\n");
+        } else {
+            if (ser_in) { ser_in->setBuffered(true); }
+            if (ser_out) { ser_out->setBuffered(true); }
+        }
+    }
+
     if (ser_in) {
         QObject::connect(ser_in, &QIODevice::readyRead, ser_port, &SerialPort::rx_queue_check);
         QObject::connect(ser_port, &SerialPort::rx_byte_pool, ser_in, &CharIOHandler::readBytePoll);
@@ -422,8 +454,8 @@ void configure_osemu(QCommandLineParser &p, MachineConfig &config, Machine *mach
             config.osemu_fs_root());
         if (std_out) {
             machine::Machine::connect(
-                osemu_handler, &osemu::OsSyscallExceptionHandler::char_written,
-                std_out, QOverload<int, unsigned>::of(&CharIOHandler::writeByte));
+                osemu_handler, &osemu::OsSyscallExceptionHandler::chars_written,
+                std_out, &CharIOHandler::writeBytes);
         }
         /*connect(
             osemu_handler, &osemu::OsSyscallExceptionHandler::rx_byte_pool, terminal,
@@ -441,6 +473,45 @@ void configure_osemu(QCommandLineParser &p, MachineConfig &config, Machine *mach
     }
 }
 
+void configure_lcd_capture(QCommandLineParser &p, Machine &machine) {
+    if (!p.isSet("lcd-capture")) {
+        if (p.isSet("lcd-capture-cycles") || p.isSet("lcd-capture-vsync")) {
+            fprintf(stderr, "LCD capture file name (--lcd-capture) missing.\n");
+            exit(EXIT_FAILURE);
+        }
+        return;
+    }
+    auto *capture = new FrameCapture(&machine, p.values("lcd-capture").last());
+    capture->setParent(&machine);
+
+    if (p.isSet("lcd-capture-cycles")) {
+        bool ok;
+        quint64 cycles = p.values("lcd-capture-cycles").last().toULongLong(&ok, 0);
+        if (!ok || cycles == 0) {
+            fprintf(stderr, "LCD capture cycle interval specification error.\n");
+            exit(EXIT_FAILURE);
+        }
+        capture->set_cycle_interval(cycles);
+    }
+    if (p.isSet("lcd-capture-vsync")) {
+        bool ok = true;
+        QString str = p.values("lcd-capture-vsync").last();
+        Address address;
+        if (str.size() >= 1 && !str.at(0).isDigit() && machine.symbol_table() != nullptr) {
+            SymbolValue _address;
+            ok = machine.symbol_table()->name_to_value(_address, str);
+            address = Address(_address);
+        } else {
+            address = Address(str.toULong(&ok, 0));
+        }
+        if (!ok) {
+            fprintf(stderr, "LCD capture vsync address specification error.\n");
+            exit(EXIT_FAILURE);
+        }
+        capture->set_vsync_address(address);
+    }
+}
+
 void load_ranges(Machine &machine, const QStringList &ranges) {
     for (const QString &range_arg : ranges) {
         bool ok = true;
@@ -463,6 +534,16 @@ void load_ranges(Machine &machine, const QStringList &ranges) {
             fprintf(stderr, "Range start/length specification error.\n");
             exit(EXIT_FAILURE);
         }
+        QString path = range_arg.mid(comma1 + 1);
+        RangeFormat format = range_format_from_path(path);
+        if (format != RangeFormat::TEXT) {
+            QString error;
+            if (!load_range_block(machine.memory_data_bus_rw(), start, path, format, error)) {
+                fprintf(stderr, "Load range failed: %s\n", qPrintable(error));
+                exit(EXIT_FAILURE);
+            }
+            continue;
+        }
         ifstream in;
         in.open(range_arg.mid(comma1 + 1).toLocal8Bit().data(), ios::in);
         Address addr = start;
@@ -542,6 +623,8 @@ int main(int argc, char *argv[]) {
 
     load_ranges(machine, p.values("load-range"));
 
+    configure_lcd_capture(p, machine);
+
     machine.play();
     return QCoreApplication::exec();
 }
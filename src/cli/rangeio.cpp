@@ -0,0 +1,167 @@
+#include "rangeio.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+using namespace machine;
+
+RangeFormat range_format_from_path(const QString &path) {
+    QString suffix = QFileInfo(path).suffix().toLower();
+    if (suffix == "bin" || suffix == "raw") { return RangeFormat::BINARY; }
+    if (suffix == "hex" || suffix == "ihex") { return RangeFormat::IHEX; }
+    return RangeFormat::TEXT;
+}
+
+static bool load_ihex(FrontendMemory *mem, Address start, QFile &file, QString &error) {
+    uint64_t base = 0;
+    int line_number = 0;
+    // Consecutive records are merged into a single block write.
+    QByteArray block;
+    uint64_t block_address = 0;
+    auto flush = [&]() {
+        mem->write_block(start + block_address, block.constData(), block.size(), ae::INTERNAL);
+        block.clear();
+    };
+
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().trimmed();
+        line_number++;
+        if (line.isEmpty()) { continue; }
+        QByteArray record = QByteArray::fromHex(line.mid(1));
+        if (line.at(0) != ':' || record.size() < 5 || record.size() * 2 != line.size() - 1
+            || record.size() != uint8_t(record.at(0)) + 5) {
+            error = QString("malformed Intel HEX record on line %1").arg(line_number);
+            return false;
+        }
+        uint8_t checksum = 0;
+        for (char byte : record) {
+            checksum += uint8_t(byte);
+        }
+        if (checksum != 0) {
+            error = QString("Intel HEX checksum error on line %1").arg(line_number);
+            return false;
+        }
+        auto count = uint8_t(record.at(0));
+        uint16_t offset = (uint8_t(record.at(1)) << 8) | uint8_t(record.at(2));
+        uint8_t type = record.at(3);
+        QByteArray data = record.mid(4, count);
+        if ((type == 0x02 || type == 0x04) && data.size() != 2) {
+            error = QString("malformed Intel HEX address record on line %1").arg(line_number);
+            return false;
+        }
+        switch (type) {
+        case 0x00: {
+            uint64_t address = base + offset;
+            if (block.isEmpty()) {
+                block_address = address;
+            } else if (block_address + block.size() != address) {
+                flush();
+                block_address = address;
+            }
+            block.append(data);
+            break;
+        }
+        case 0x01: flush(); return true;
+        case 0x02:
+            base = ((uint8_t(data.at(0)) << 8) | uint8_t(data.at(1))) << 4;
+            break;
+        case 0x04:
+            base = uint64_t((uint8_t(data.at(0)) << 8) | uint8_t(data.at(1))) << 16;
+            break;
+        default: break; // Start address records are ignored.
+        }
+    }
+    flush();
+    return true;
+}
+
+bool load_range_block(
+    FrontendMemory *mem,
+    Address start,
+    const QString &path,
+    RangeFormat format,
+    QString &error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("cannot open %1 for reading").arg(path);
+        return false;
+    }
+    if (format == RangeFormat::IHEX) { return load_ihex(mem, start, file, error); }
+
+    qint64 size = file.size();
+    if (size == 0) { return true; }
+    // Mapping avoids a copy of the whole file, read is a fallback for special files.
+    uchar *data = file.map(0, size);
+    if (data != nullptr) {
+        mem->write_block(start, data, size, ae::INTERNAL);
+        file.unmap(data);
+    } else {
+        QByteArray content = file.readAll();
+        mem->write_block(start, content.constData(), content.size(), ae::INTERNAL);
+    }
+    return true;
+}
+
+static void
+append_ihex_record(QByteArray &out, uint8_t type, uint16_t offset, const QByteArray &data) {
+    QByteArray record;
+    record.append(char(data.size()));
+    record.append(char(offset >> 8));
+    record.append(char(offset));
+    record.append(char(type));
+    record.append(data);
+    uint8_t checksum = 0;
+    for (char byte : record) {
+        checksum += uint8_t(byte);
+    }
+    record.append(char(-checksum));
+    out.append(':');
+    out.append(record.toHex().toUpper());
+    out.append('\n');
+}
+
+bool dump_range_block(
+    const FrontendMemory *mem,
+    Address start,
+    size_t len,
+    const QString &path,
+    RangeFormat format,
+    QString &error) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = QString("cannot open %1 for writing").arg(path);
+        return false;
+    }
+    QByteArray content(int(len), 0);
+    mem->read_block(content.data(), start, len, ae::INTERNAL);
+
+    if (format == RangeFormat::IHEX) {
+        constexpr int RECORD_SIZE = 16;
+        QByteArray out;
+        uint64_t upper = ~uint64_t(0);
+        for (int i = 0; i < content.size();) {
+            // Record addresses are relative to the range start, as expected by the loader.
+            auto address = uint64_t(i);
+            int count = qMin(RECORD_SIZE, content.size() - i);
+            // Records must not cross 64 KiB boundary of the linear address.
+            count = qMin<int>(count, 0x10000 - (address & 0xffff));
+            if ((address >> 16) != upper) {
+                upper = address >> 16;
+                QByteArray ext;
+                ext.append(char(upper >> 8));
+                ext.append(char(upper));
+                append_ihex_record(out, 0x04, 0, ext);
+            }
+            append_ihex_record(out, 0x00, address & 0xffff, content.mid(i, count));
+            i += count;
+        }
+        append_ihex_record(out, 0x01, 0, QByteArray());
+        content = out;
+    }
+
+    if (file.write(content) != content.size()) {
+        error = QString("failure writing %1").arg(path);
+        return false;
+    }
+    return true;
+}
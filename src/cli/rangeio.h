@@ -0,0 +1,44 @@
+#ifndef RANGEIO_H
+#define RANGEIO_H
+
+#include "machine/memory/address.h"
+#include "machine/memory/frontend_memory.h"
+
+#include <QString>
+
+/**
+ * File formats of memory ranges loaded and dumped by the CLI.
+ *
+ * The format is chosen by the file suffix. Binary and Intel HEX ranges are transferred to the
+ * memory as blocks; the text format (one 32bit word per line) is kept for compatibility.
+ */
+enum class RangeFormat {
+    TEXT,
+    BINARY, //> `.bin`, `.raw`
+    IHEX,   //> `.hex`, `.ihex`, Intel HEX records, addresses relative to the range start
+};
+
+RangeFormat range_format_from_path(const QString &path);
+
+/**
+ * Load binary or Intel HEX file to memory at the given address.
+ *
+ * @param error     description of the problem when false is returned
+ */
+bool load_range_block(
+    machine::FrontendMemory *mem,
+    machine::Address start,
+    const QString &path,
+    RangeFormat format,
+    QString &error);
+
+/** Dump memory range to binary or Intel HEX file. */
+bool dump_range_block(
+    const machine::FrontendMemory *mem,
+    machine::Address start,
+    size_t len,
+    const QString &path,
+    RangeFormat format,
+    QString &error);
+
+#endif // RANGEIO_H
@@ -0,0 +1,163 @@
+#include "rangeio.test.h"
+
+#include "machine/memory/backend/memory.h"
+#include "machine/memory/memory_bus.h"
+#include "rangeio.h"
+
+#include <QTemporaryDir>
+
+using namespace machine;
+
+/** Memory covering the whole address space, accessed through a data bus. */
+struct TestMemorySpace {
+    Memory memory { LITTLE };
+    MemoryDataBus bus { LITTLE };
+
+    TestMemorySpace() { bus.insert_device_to_range(&memory, 0x0_addr, 0xffffffff_addr, false); }
+
+    QByteArray read(Address start, size_t size) const {
+        QByteArray content(int(size), 0);
+        bus.read_block(content.data(), start, size, ae::INTERNAL);
+        return content;
+    }
+};
+
+static QByteArray test_pattern(int size) {
+    QByteArray content(size, 0);
+    for (int i = 0; i < size; i++) {
+        content[i] = char(i * 7 + 3);
+    }
+    return content;
+}
+
+static void write_file(const QString &path, const QByteArray &content) {
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(content), qint64(content.size()));
+}
+
+static QByteArray read_file(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) { return {}; }
+    return file.readAll();
+}
+
+void TestRangeIo::rangeio_format() {
+    QCOMPARE(range_format_from_path("data.bin"), RangeFormat::BINARY);
+    QCOMPARE(range_format_from_path("data.RAW"), RangeFormat::BINARY);
+    QCOMPARE(range_format_from_path("data.hex"), RangeFormat::IHEX);
+    QCOMPARE(range_format_from_path("dir.bin/data.ihex"), RangeFormat::IHEX);
+    QCOMPARE(range_format_from_path("data.txt"), RangeFormat::TEXT);
+    QCOMPARE(range_format_from_path("data"), RangeFormat::TEXT);
+}
+
+void TestRangeIo::rangeio_binary() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString error;
+    const QByteArray pattern = test_pattern(1000);
+    TestMemorySpace source;
+    source.bus.write_block(0x1003_addr, pattern.constData(), pattern.size(), ae::INTERNAL);
+
+    const QString path = dir.filePath("range.bin");
+    QVERIFY(dump_range_block(
+        &source.bus, 0x1003_addr, pattern.size(), path, RangeFormat::BINARY, error));
+    QCOMPARE(read_file(path), pattern);
+
+    TestMemorySpace target;
+    QVERIFY(load_range_block(&target.bus, 0x20001_addr, path, RangeFormat::BINARY, error));
+    QCOMPARE(target.read(0x20001_addr, pattern.size()), pattern);
+    // Nothing is written around the range.
+    QCOMPARE(target.read(0x20000_addr, 1), QByteArray(1, 0));
+    QCOMPARE(target.read(0x20001_addr + pattern.size(), 1), QByteArray(1, 0));
+
+    // Empty file loads nothing.
+    const QString empty_path = dir.filePath("empty.bin");
+    write_file(empty_path, QByteArray());
+    QVERIFY(load_range_block(&target.bus, 0x0_addr, empty_path, RangeFormat::BINARY, error));
+    const QString missing_path = dir.filePath("missing.bin");
+    QVERIFY(!load_range_block(&target.bus, 0x0_addr, missing_path, RangeFormat::BINARY, error));
+    QVERIFY(error.contains("missing.bin"));
+}
+
+void TestRangeIo::rangeio_ihex_load() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("range.hex");
+    write_file(
+        path, ":0B0010006164647265737320676170A7\n" // "address gap" at 0x10
+              ":020000021000EC\n"                   // segment base 0x10000
+              ":0400000001020304F2\n"
+              ":0400040005060708DE\n" // continues previous record
+              "\n"
+              ":020000040002F8\n" // linear base 0x20000
+              ":02000000AABB99\n"
+              ":00000001FF\n"
+              ":02000000CCDD55\n"); // after end of file record
+
+    TestMemorySpace target;
+    QString error;
+    QVERIFY(load_range_block(&target.bus, 0x100000_addr, path, RangeFormat::IHEX, error));
+    QCOMPARE(target.read(0x10000f_addr, 13), QByteArray("\0address gap\0", 13));
+    QCOMPARE(target.read(0x110000_addr, 9), QByteArray("\x01\x02\x03\x04\x05\x06\x07\x08\0", 9));
+    QCOMPARE(target.read(0x120000_addr, 4), QByteArray("\xaa\xbb\0\0", 4));
+}
+
+void TestRangeIo::rangeio_ihex_roundtrip() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString error;
+    // Range crosses 64 KiB boundary relative to its start.
+    const QByteArray pattern = test_pattern(0x10020);
+    TestMemorySpace source;
+    source.bus.write_block(0x2fff0_addr, pattern.constData(), pattern.size(), ae::INTERNAL);
+
+    const QString path = dir.filePath("range.hex");
+    QVERIFY(dump_range_block(
+        &source.bus, 0x2fff0_addr, pattern.size(), path, RangeFormat::IHEX, error));
+    const QByteArray hex = read_file(path);
+    QVERIFY(hex.startsWith(":020000040000FA\n:10000000"));
+    QVERIFY(hex.contains("\n:020000040001F9\n:10000000"));
+    QVERIFY(hex.endsWith("\n:00000001FF\n"));
+
+    TestMemorySpace target;
+    QVERIFY(load_range_block(&target.bus, 0x80000_addr, path, RangeFormat::IHEX, error));
+    QCOMPARE(target.read(0x80000_addr, pattern.size()), pattern);
+    QCOMPARE(target.read(0x80000_addr + pattern.size(), 1), QByteArray(1, 0));
+}
+
+void TestRangeIo::rangeio_ihex_malformed_data() {
+    QTest::addColumn<QByteArray>("record");
+    QTest::addColumn<QString>("message");
+
+    QTest::newRow("missing colon") << QByteArray("0B0010006164647265737320676170A7")
+                                   << "malformed Intel HEX record";
+    QTest::newRow("odd digits") << QByteArray(":0B0010006164647265737320676170A")
+                                << "malformed Intel HEX record";
+    QTest::newRow("not hex") << QByteArray(":0B00100061646472657373206761XXA7")
+                             << "malformed Intel HEX record";
+    QTest::newRow("count") << QByteArray(":0C0010006164647265737320676170A7")
+                           << "malformed Intel HEX record";
+    QTest::newRow("short") << QByteArray(":0000") << "malformed Intel HEX record";
+    QTest::newRow("checksum") << QByteArray(":0B0010006164647265737320676170A8")
+                              << "Intel HEX checksum error";
+    QTest::newRow("address record") << QByteArray(":0100000410EB")
+                                    << "malformed Intel HEX address record";
+}
+
+void TestRangeIo::rangeio_ihex_malformed() {
+    QFETCH(QByteArray, record);
+    QFETCH(QString, message);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("range.hex");
+    write_file(path, ":0400000001020304F2\n" + record + "\n:00000001FF\n");
+
+    TestMemorySpace target;
+    QString error;
+    QVERIFY(!load_range_block(&target.bus, 0x1000_addr, path, RangeFormat::IHEX, error));
+    QCOMPARE(error, message + " on line 2");
+}
+
+QTEST_APPLESS_MAIN(TestRangeIo)
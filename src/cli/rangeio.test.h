@@ -0,0 +1,18 @@
+#ifndef RANGEIO_TEST_H
+#define RANGEIO_TEST_H
+
+#include <QtTest>
+
+class TestRangeIo : public QObject {
+    Q_OBJECT
+
+private slots:
+    static void rangeio_format();
+    static void rangeio_binary();
+    static void rangeio_ihex_load();
+    static void rangeio_ihex_roundtrip();
+    static void rangeio_ihex_malformed_data();
+    static void rangeio_ihex_malformed();
+};
+
+#endif // RANGEIO_TEST_H
@@ -1,5 +1,7 @@
 #include "reporter.h"
 
+#include "rangeio.h"
+
 #include <cinttypes>
 
 using namespace machine;
@@ -135,6 +137,12 @@ void Reporter::report_pc() {
     if (dump_format & DumpFormat::JSON) {
         QJsonObject regs = dump_data_json["regs"].toObject();
         regs["PC"] = value;
+        const SymbolTable *symtab = machine->symbol_table();
+        QString symbol;
+        if (symtab != nullptr
+            && symtab->location_to_symbol_offset(symbol, machine->registers()->read_pc().get_raw())) {
+            regs["PC_symbol"] = symbol;
+        }
         dump_data_json["regs"] = regs;
     }
     if (dump_format & DumpFormat::CONSOLE) { printf("PC:%s\n", qPrintable(value)); }
@@ -201,6 +209,16 @@ void Reporter::report_cache(const char *cache_name, const Cache &cache) {
 }
 
 void Reporter::report_range(const Reporter::DumpRange &range) {
+    RangeFormat format = range_format_from_path(range.path_to_write);
+    if (format != RangeFormat::TEXT) {
+        QString error;
+        if (!dump_range_block(
+                machine->memory_data_bus(), range.start, range.len, range.path_to_write, format,
+                error)) {
+            fprintf(stderr, "Dump range failed: %s\n", qPrintable(error));
+        }
+        return;
+    }
     FILE *out = fopen(range.path_to_write.toLocal8Bit().data(), "w");
     if (out == nullptr) {
         fprintf(
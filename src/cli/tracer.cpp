@@ -4,7 +4,7 @@
 
 using namespace machine;
 
-Tracer::Tracer(Machine *machine) : core_state(machine->core()->get_state()) {
+Tracer::Tracer(Machine *machine) : machine(machine), core_state(machine->core()->get_state()) {
     cycle_limit = 0;
 
     connect(machine->core(), &Core::step_done, this, &Tracer::step_output);
@@ -14,10 +14,23 @@ template<typename StageStruct>
 void trace_instruction_in_stage(
     const char *stage_name,
     const StageStruct &stage,
-    const WritebackInternalState &wb) {
+    const WritebackInternalState &wb,
+    const QString &suffix) {
+    char inst_text[Instruction::MAX_STR_SIZE];
+    wb.inst.to_str(inst_text, sizeof(inst_text), stage.inst_addr);
     printf(
-        "%s: %s%s\n", stage_name, (stage.excause != EXCAUSE_NONE) ? "!" : "",
-        qPrintable(wb.inst.to_str(stage.inst_addr)));
+        "%s: %s%s%s\n", stage_name, (stage.excause != EXCAUSE_NONE) ? "!" : "", inst_text,
+        qPrintable(suffix));
+}
+
+QString Tracer::symbol_suffix(Address address) const {
+    if (!trace_symbols) { return {}; }
+    const SymbolTable *symtab = machine->symbol_table();
+    QString text;
+    if (symtab == nullptr || !symtab->location_to_symbol_offset(text, address.get_raw())) {
+        return {};
+    }
+    return " <" + text + ">";
 }
 
 void Tracer::step_output() {
@@ -27,15 +40,29 @@ void Tracer::step_output() {
     const auto &mem = core_state.pipeline.memory.internal;
     const auto &mem_wb = core_state.pipeline.memory.final;
     const auto &wb = core_state.pipeline.writeback.internal;
-    if (trace_fetch) { trace_instruction_in_stage("Fetch", if_id, wb); }
-    if (trace_decode) { trace_instruction_in_stage("Decode", id_ex, wb); }
-    if (trace_execute) { trace_instruction_in_stage("Execute", ex_mem, wb); }
-    if (trace_memory) { trace_instruction_in_stage("Memory", mem_wb, wb); }
+    if (trace_fetch) {
+        trace_instruction_in_stage("Fetch", if_id, wb, symbol_suffix(if_id.inst_addr));
+    }
+    if (trace_decode) {
+        trace_instruction_in_stage("Decode", id_ex, wb, symbol_suffix(id_ex.inst_addr));
+    }
+    if (trace_execute) {
+        trace_instruction_in_stage("Execute", ex_mem, wb, symbol_suffix(ex_mem.inst_addr));
+    }
+    if (trace_memory) {
+        trace_instruction_in_stage("Memory", mem_wb, wb, symbol_suffix(mem_wb.inst_addr));
+    }
     if (trace_writeback) {
         // All exceptions are resolved in memory, therefore there is no excause field in WB.
-        printf("Writeback: %s\n", qPrintable(wb.inst.to_str(wb.inst_addr)));
+        char inst_text[Instruction::MAX_STR_SIZE];
+        wb.inst.to_str(inst_text, sizeof(inst_text), wb.inst_addr);
+        printf("Writeback: %s%s\n", inst_text, qPrintable(symbol_suffix(wb.inst_addr)));
+    }
+    if (trace_pc) {
+        printf(
+            "PC: %" PRIx64 "%s\n", if_id.inst_addr.get_raw(),
+            qPrintable(symbol_suffix(if_id.inst_addr)));
     }
-    if (trace_pc) { printf("PC: %" PRIx64 "\n", if_id.inst_addr.get_raw()); }
     if (trace_regs_gp && wb.regwrite && regs_to_trace.at(wb.num_rd)) {
         printf("GP %zu: %" PRIx64 "\n", size_t(wb.num_rd), wb.value.as_u64());
     }
@@ -23,13 +23,17 @@ private slots:
     void step_output();
 
 private:
+    /** Containing symbol of the address formatted as ` <name+0x10>` when symbols are traced. */
+    QString symbol_suffix(machine::Address address) const;
+
+    machine::Machine *const machine;
     const machine::CoreState &core_state;
 
 public:
     std::array<bool, machine::REGISTER_COUNT> regs_to_trace = {};
     bool trace_fetch = false, trace_decode = false, trace_execute = false, trace_memory = false,
          trace_writeback = false, trace_pc = false, trace_wrmem = false,  trace_rdmem = false,
-         trace_regs_gp = false;
+         trace_regs_gp = false, trace_symbols = false;
     quint64 cycle_limit;
 };
 
@@ -275,8 +275,8 @@ void MainWindow::create_core(
             config.osemu_fs_root());
         osemu_handler->setParent(new_machine);
         connect(
-            osemu_handler, &osemu::OsSyscallExceptionHandler::char_written, terminal.data(),
-            QOverload<int, unsigned int>::of(&TerminalDock::tx_byte));
+            osemu_handler, &osemu::OsSyscallExceptionHandler::chars_written, terminal.data(),
+            &TerminalDock::tx_bytes);
         connect(
             osemu_handler, &osemu::OsSyscallExceptionHandler::rx_byte_pool, terminal.data(),
             &TerminalDock::rx_byte_pool);
@@ -321,6 +321,9 @@ void MainWindow::create_core(
     connect(
         machine->core(), &machine::Core::step_done, program.data(),
         &ProgramDock::update_pipeline_addrs);
+    connect(machine.data(), &machine::Machine::batch_done, program.data(), [this]() {
+        program->update_pipeline_addrs(machine->core()->get_state());
+    });
 
     // Set status to ready
     machine_status(machine::Machine::ST_READY);
@@ -482,7 +485,8 @@ void MainWindow::set_speed() {
     } else if (ui->ips10->isChecked()) {
         machine->set_speed(100);
     } else if (ui->ipsMax->isChecked()) {
-        machine->set_speed(0, 100);
+        // Views are refreshed after each batch, which is kept close to the display frame rate.
+        machine->set_speed(0, 20);
     } else {
         machine->set_speed(0);
     }
@@ -750,7 +754,8 @@ void MainWindow::compile_source() {
 
     connect(&sasm, &SimpleAsm::report_message, this, &MainWindow::report_message);
 
-    sasm.setup(mem, &symtab, machine::Address(0x00000200), machine->core()->get_xlen());
+    sasm.setup(
+        mem, &symtab, machine::Address(0x00000200), machine->core()->get_xlen(), &asm_state);
 
     int ln = 1;
     for (QTextBlock block = content->begin(); block.isValid(); block = block.next(), ln++) {
@@ -141,6 +141,7 @@ private:
     QSharedPointer<QSettings> settings;
 
     Box<machine::Machine> machine; // Current simulated machine
+    SimpleAsmIncrementalState asm_state; // Lines assembled by the last compile_source
 
     void show_dockwidget(
         QDockWidget *w,
@@ -0,0 +1,115 @@
+#include "memoryviewport.h"
+
+#include "common/endian.h"
+
+#include <cstring>
+
+using ae = machine::AccessEffects; // For enum values, the type is obvious from context.
+
+void MemoryViewport::invalidate() {
+    valid = false;
+    bytes.clear();
+    status.clear();
+}
+
+QVector<MemoryViewport::RowRange> MemoryViewport::refresh(
+    const machine::FrontendMemory *mem,
+    const machine::FrontendMemory *status_source,
+    machine::Address start,
+    unsigned rows,
+    unsigned row_bytes,
+    unsigned cell_bytes) {
+    QVector<RowRange> changed;
+    if (mem == nullptr || row_bytes == 0 || cell_bytes == 0) {
+        invalidate();
+        return changed;
+    }
+
+    const bool same_window = valid && this->mem == mem && this->status_source == status_source
+                             && this->start == start && this->rows == rows
+                             && this->row_bytes == row_bytes && this->cell_bytes == cell_bytes;
+    const unsigned cells_per_row = row_bytes / cell_bytes;
+
+    QByteArray new_bytes(int(rows * row_bytes), Qt::Uninitialized);
+    if (!new_bytes.isEmpty()) {
+        mem->read_block(new_bytes.data(), start, new_bytes.size(), ae::INTERNAL);
+    }
+    QVector<uint8_t> new_status;
+    if (status_source != nullptr) {
+        new_status.resize(int(rows * cells_per_row));
+        for (int i = 0; i < new_status.size(); i++) {
+            new_status[i] = status_source->location_status(start + uint64_t(i) * cell_bytes);
+        }
+    }
+
+    if (!same_window) {
+        if (rows > 0) { changed.append({ 0, int(rows) - 1 }); }
+    } else {
+        for (unsigned row = 0; row < rows; row++) {
+            bool differs = memcmp(
+                               bytes.constData() + row * row_bytes,
+                               new_bytes.constData() + row * row_bytes, row_bytes)
+                           != 0;
+            if (!differs && status_source != nullptr) {
+                differs = memcmp(
+                              status.constData() + row * cells_per_row,
+                              new_status.constData() + row * cells_per_row, cells_per_row)
+                          != 0;
+            }
+            if (!differs) { continue; }
+            if (!changed.isEmpty() && changed.last().second == int(row) - 1) {
+                changed.last().second = int(row);
+            } else {
+                changed.append({ int(row), int(row) });
+            }
+        }
+    }
+
+    valid = true;
+    swap = mem->simulated_machine_endian != NATIVE_ENDIAN;
+    this->mem = mem;
+    this->status_source = status_source;
+    this->start = start;
+    this->rows = rows;
+    this->row_bytes = row_bytes;
+    this->cell_bytes = cell_bytes;
+    bytes = new_bytes;
+    status = new_status;
+    return changed;
+}
+
+bool MemoryViewport::contains(machine::Address address, unsigned size) const {
+    if (!valid || address < start) { return false; }
+    return uint64_t(address - start) + size <= uint64_t(bytes.size());
+}
+
+int MemoryViewport::row_of(machine::Address address) const {
+    if (!contains(address, 1)) { return -1; }
+    return int((address - start) / row_bytes);
+}
+
+uint32_t MemoryViewport::read(machine::Address address, unsigned size) const {
+    const char *src = bytes.constData() + (address - start);
+    switch (size) {
+    case 1: {
+        uint8_t value;
+        memcpy(&value, src, sizeof(value));
+        return value;
+    }
+    case 2: {
+        uint16_t value;
+        memcpy(&value, src, sizeof(value));
+        return byteswap_if(value, swap);
+    }
+    default: {
+        uint32_t value;
+        memcpy(&value, src, sizeof(value));
+        return byteswap_if(value, swap);
+    }
+    }
+}
+
+machine::LocationStatus MemoryViewport::location_status(machine::Address address) const {
+    if (status.isEmpty() || !contains(address, 1)) { return machine::LOCSTAT_NONE; }
+    return machine::LocationStatus(status[int((address - start) / cell_bytes)]);
+}
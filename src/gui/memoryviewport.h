@@ -0,0 +1,78 @@
+#ifndef MEMORYVIEWPORT_H
+#define MEMORYVIEWPORT_H
+
+#include "machine/machinedefs.h"
+#include "machine/memory/address.h"
+#include "machine/memory/frontend_memory.h"
+
+#include <QByteArray>
+#include <QVector>
+#include <utility>
+
+/**
+ * Copy of the window of memory shown by a table view (memory, program).
+ *
+ * The window is read from the memory as a single block once per refresh and the views are then
+ * painted from the copy. Refresh compares the new content (and location status of cells, when
+ * a status source is given) with the previous one and reports only rows which have changed, so
+ * the model does not have to invalidate the whole table after each step.
+ */
+class MemoryViewport {
+public:
+    /** Inclusive range of rows relative to the start of the window. */
+    using RowRange = std::pair<int, int>;
+
+    /** Drop the copy. Next refresh reports all rows as changed. */
+    void invalidate();
+
+    /**
+     * Read the window from memory.
+     *
+     * @param mem           memory the window is read from
+     * @param status_source memory queried for location status of each cell (e.g. cache), can be
+     *                      nullptr
+     * @param start         address of the first row
+     * @param rows          number of rows in the window
+     * @param row_bytes     number of bytes in a row
+     * @param cell_bytes    granularity of location status
+     * @return              ranges of rows which differ from the previous refresh, all rows when
+     *                      the window geometry has changed
+     */
+    QVector<RowRange> refresh(
+        const machine::FrontendMemory *mem,
+        const machine::FrontendMemory *status_source,
+        machine::Address start,
+        unsigned rows,
+        unsigned row_bytes,
+        unsigned cell_bytes);
+
+    [[nodiscard]] bool is_valid() const { return valid; }
+    [[nodiscard]] machine::Address get_start() const { return start; }
+
+    /** The whole range [address, address + size) is held by the copy. */
+    [[nodiscard]] bool contains(machine::Address address, unsigned size) const;
+    /** Index of the window row holding the address or -1. */
+    [[nodiscard]] int row_of(machine::Address address) const;
+
+    /**
+     * Value of 1, 2 or 4 bytes converted from simulated machine endian.
+     * The range has to be covered by the copy (@see contains).
+     */
+    [[nodiscard]] uint32_t read(machine::Address address, unsigned size) const;
+    /** Location status of the cell holding the address as seen during the last refresh. */
+    [[nodiscard]] machine::LocationStatus location_status(machine::Address address) const;
+
+private:
+    bool valid = false;
+    bool swap = false;
+    const machine::FrontendMemory *mem = nullptr;
+    const machine::FrontendMemory *status_source = nullptr;
+    machine::Address start;
+    unsigned rows = 0;
+    unsigned row_bytes = 0;
+    unsigned cell_bytes = 0;
+    QByteArray bytes;
+    QVector<uint8_t> status;
+};
+
+#endif // MEMORYVIEWPORT_H
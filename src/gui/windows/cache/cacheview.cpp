@@ -2,6 +2,7 @@
 
 #include "fontsize.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include <QtAlgorithms>
@@ -37,8 +38,6 @@ CacheAddressBlock::CacheAddressBlock(const machine::Cache *cache, unsigned width
     tag = 0;
     row = 0;
     col = 0;
-
-    connect(cache, &machine::Cache::cache_update, this, &CacheAddressBlock::cache_update);
 }
 
 QRectF CacheAddressBlock::boundingRect() const {
@@ -118,86 +117,41 @@ void CacheAddressBlock::paint(
     }
 }
 
-void CacheAddressBlock::cache_update(
-    unsigned associat,
-    unsigned set,
-    unsigned col,
-    bool valid,
-    bool dirty,
-    uint32_t tag,
-    const uint32_t *data,
-    bool write) {
-    (void)associat;
-    (void)valid;
-    (void)dirty;
-    (void)data;
-    (void)write;
-
-    this->tag = tag;
-    this->row = set;
-    this->col = col;
+void CacheAddressBlock::set_access(const machine::Cache::AccessRecord &access) {
+    if (tag == access.tag && row == access.row && col == access.col) { return; }
+    tag = access.tag;
+    row = access.row;
+    col = access.col;
     update();
 }
 
 CacheViewBlock::CacheViewBlock(const machine::Cache *cache, unsigned block, bool last)
     : QGraphicsObject(nullptr)
+    , cache(cache)
     , simulated_machine_endian(cache->simulated_machine_endian) {
     islast = last;
     this->block = block;
     rows = cache->get_config().set_count();
     columns = cache->get_config().block_size();
+    enabled = cache->get_config().enabled();
+    dirty = cache->get_config().write_policy() == machine::CacheConfig::WP_BACK;
     curr_row = 0;
     last_set = 0;
     last_col = 0;
     last_highlighted = false;
+    last_write = false;
+    // Paint only rows in the exposed area.
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
 
-    QFont font;
     font.setPixelSize(FontSize::SIZE7);
 
-    validity = new QGraphicsSimpleTextItem *[rows];
-    if (cache->get_config().write_policy() == machine::CacheConfig::WP_BACK) {
-        dirty = new QGraphicsSimpleTextItem *[rows];
-    } else {
-        dirty = nullptr;
-    }
-    tag = new QGraphicsSimpleTextItem *[rows];
-    data = new QGraphicsSimpleTextItem **[rows];
-    int row_y = 1;
-    for (unsigned i = 0; i < rows; i++) {
-        int row_x = 2;
-        validity[i] = new QGraphicsSimpleTextItem("0", this);
-        validity[i]->setPos(row_x, row_y);
-        validity[i]->setFont(font);
-        row_x += VD_WIDTH;
-        if (dirty) {
-            dirty[i] = new QGraphicsSimpleTextItem(this);
-            dirty[i]->setPos(row_x, row_y);
-            dirty[i]->setFont(font);
-            row_x += VD_WIDTH;
-        }
-        tag[i] = new QGraphicsSimpleTextItem(this);
-        tag[i]->setPos(row_x, row_y);
-        tag[i]->setFont(font);
-        row_x += DATA_WIDTH;
-
-        data[i] = new QGraphicsSimpleTextItem *[columns];
-        for (unsigned y = 0; y < columns; y++) {
-            data[i][y] = new QGraphicsSimpleTextItem(this);
-            data[i][y]->setPos(row_x, row_y);
-            data[i][y]->setFont(font);
-            row_x += DATA_WIDTH;
-        }
-
-        row_y += ROW_HEIGHT;
-    }
-
     unsigned wd = 1;
     auto *l_validity = new QGraphicsSimpleTextItem("V", this);
     l_validity->setFont(font);
     QRectF box = l_validity->boundingRect();
     l_validity->setPos(wd + (VD_WIDTH - box.width()) / 2, -1 - box.height());
     wd += VD_WIDTH;
-    if (cache->get_config().write_policy() == machine::CacheConfig::WP_BACK) {
+    if (dirty) {
         auto *l_dirty = new QGraphicsSimpleTextItem("D", this);
         l_dirty->setFont(font);
         box = l_dirty->boundingRect();
@@ -213,18 +167,6 @@ CacheViewBlock::CacheViewBlock(const machine::Cache *cache, unsigned block, bool
     l_data->setFont(font);
     box = l_data->boundingRect();
     l_data->setPos(wd + (columns * DATA_WIDTH - box.width()) / 2, -1 - box.height());
-
-    connect(cache, &machine::Cache::cache_update, this, &CacheViewBlock::cache_update);
-}
-
-CacheViewBlock::~CacheViewBlock() {
-    delete[] validity;
-    delete[] dirty;
-    delete[] tag;
-    for (unsigned y = 0; y < rows; y++) {
-        delete[] data[y];
-    }
-    delete[] data;
 }
 
 QRectF CacheViewBlock::boundingRect() const {
@@ -237,7 +179,7 @@ QRectF CacheViewBlock::boundingRect() const {
 
 void CacheViewBlock::paint(
     QPainter *painter,
-    const QStyleOptionGraphicsItem *option __attribute__((unused)),
+    const QStyleOptionGraphicsItem *option,
     QWidget *widget __attribute__((unused))) {
     // Draw horizontal lines
     for (unsigned i = 0; i <= rows; i++) {
@@ -333,52 +275,85 @@ void CacheViewBlock::paint(
         painter->drawLine(-5, -16, -5, islast ? selected : bottom + 40);
         painter->drawLine(-5, selected, 0, selected);
     }
+
+    // Content of the rows in the exposed area
+    if (!enabled || rows == 0) { return; }
+    painter->setPen(p);
+    painter->setFont(font);
+    const QRectF exposed = option->exposedRect;
+    const int first = std::max(0, int(std::floor(exposed.top() / ROW_HEIGHT)));
+    const int last = std::min(int(rows) - 1, int(std::floor(exposed.bottom() / ROW_HEIGHT)));
+    for (int row = first; row <= last; row++) {
+        paint_row(painter, row);
+    }
 }
 
-void CacheViewBlock::cache_update(
-    unsigned associat,
-    unsigned set,
-    unsigned col,
-    bool valid,
-    bool dirty,
-    uint32_t tag,
-    const uint32_t *data,
-    bool write) {
-    (void)col;
-    if (associat != block) {
-        if (last_highlighted) { this->data[last_set][last_col]->setBrush(QBrush(QColor(0, 0, 0))); }
-        last_highlighted = false;
-        return; // Ignore blocks that are not used
+void CacheViewBlock::paint_row(QPainter *painter, unsigned row) const {
+    const machine::CacheLine &line = cache->get_line(block, row);
+    const int flags = Qt::AlignLeft | Qt::AlignTop;
+    const qreal row_y = row * ROW_HEIGHT + 1;
+    qreal row_x = 2;
+
+    painter->drawText(QRectF(row_x, row_y, VD_WIDTH, ROW_HEIGHT), flags, line.valid ? "1" : "0");
+    row_x += VD_WIDTH;
+    if (dirty) {
+        if (line.valid) {
+            painter->drawText(
+                QRectF(row_x, row_y, VD_WIDTH, ROW_HEIGHT), flags, line.dirty ? "1" : "0");
+        }
+        row_x += VD_WIDTH;
     }
-    validity[set]->setText(valid ? "1" : "0");
-    if (this->dirty) { this->dirty[set]->setText(valid ? (dirty ? "1" : "0") : ""); }
+    if (!line.valid) { return; }
     // TODO calculate correct size of tag
-    this->tag[set]->setText(valid ? QString("0x") + QString("%1").arg(tag, 8, 16, QChar('0')) : "");
+    painter->drawText(
+        QRectF(row_x, row_y, DATA_WIDTH, ROW_HEIGHT), flags,
+        QString("0x") + QString("%1").arg(line.tag, 8, 16, QChar('0')));
+    row_x += DATA_WIDTH;
+
+    const QPen normal = painter->pen();
     for (unsigned i = 0; i < columns; i++) {
-        this->data[set][i]->setText(
-            valid ? QString("0x")
-                        + QString("%1").arg(
-                            byteswap_if(data[i], simulated_machine_endian != NATIVE_ENDIAN), 8, 16,
-                            QChar('0'))
-                  : "");
-        //  TODO Use cache API
+        const bool highlighted = last_highlighted && row == last_set && i == last_col;
+        if (highlighted) {
+            painter->setPen(last_write ? QColor(240, 0, 0) : QColor(0, 0, 240));
+        }
+        painter->drawText(
+            QRectF(row_x, row_y, DATA_WIDTH, ROW_HEIGHT), flags,
+            QString("0x")
+                + QString("%1").arg(
+                    byteswap_if(line.data[i], simulated_machine_endian != NATIVE_ENDIAN), 8, 16,
+                    QChar('0')));
+        if (highlighted) { painter->setPen(normal); }
+        row_x += DATA_WIDTH;
     }
+}
 
-    if (last_highlighted) { this->data[last_set][last_col]->setBrush(QBrush(QColor(0, 0, 0))); }
-    if (write) {
-        this->data[set][col]->setBrush(QBrush(QColor(240, 0, 0)));
-    } else {
-        this->data[set][col]->setBrush(QBrush(QColor(0, 0, 240)));
-    }
-    last_highlighted = true;
+void CacheViewBlock::update_row(unsigned row) {
+    update(QRectF(
+        0, row * ROW_HEIGHT, VD_WIDTH + (dirty ? VD_WIDTH : 0) + DATA_WIDTH * (columns + 1) + PENW,
+        ROW_HEIGHT + PENW));
+}
 
-    curr_row = set;
-    last_set = set;
-    last_col = col;
-    update();
+void CacheViewBlock::lines_changed(const std::vector<bool> &changed) {
+    const machine::Cache::AccessRecord &access = cache->get_last_access();
+    if (last_highlighted) { update_row(last_set); }
+    for (unsigned row = 0; row < rows; row++) {
+        if (changed[block * rows + row]) { update_row(row); }
+    }
+    last_highlighted = access.valid && access.way == block;
+    if (!last_highlighted) { return; }
+    last_set = access.row;
+    last_col = access.col;
+    last_write = access.write;
+    update_row(last_set);
+    if (curr_row != last_set) {
+        curr_row = last_set;
+        // Selected row wire left of the table
+        const QRectF bounding = boundingRect();
+        update(QRectF(bounding.left(), bounding.top(), -bounding.left(), bounding.height()));
+    }
 }
 
-CacheViewScene::CacheViewScene(const machine::Cache *cache) {
+CacheViewScene::CacheViewScene(const machine::Cache *cache) : cache(cache) {
     associativity = cache->get_config().associativity();
     block = new CacheViewBlock *[associativity];
     int offset = 0;
@@ -391,8 +366,29 @@ CacheViewScene::CacheViewScene(const machine::Cache *cache) {
     ablock = new CacheAddressBlock(cache, block[0]->boundingRect().width());
     addItem(ablock);
     ablock->setPos(0, -ablock->boundingRect().height() - 16);
+
+    // Blocks paint the current content, earlier changes are not needed.
+    (void)cache->take_changed_lines();
+    update_timer.setSingleShot(true);
+    connect(&update_timer, &QTimer::timeout, this, &CacheViewScene::update_lines);
+    connect(cache, &machine::Cache::lines_changed, this, &CacheViewScene::request_update);
 }
 
 CacheViewScene::~CacheViewScene() {
     delete[] block;
 }
+
+void CacheViewScene::request_update() {
+    constexpr int FRAME_INTERVAL_MS = 16;
+    if (!update_timer.isActive()) { update_timer.start(FRAME_INTERVAL_MS); }
+}
+
+void CacheViewScene::update_lines() {
+    const std::vector<bool> changed = cache->take_changed_lines();
+    if (changed.empty()) { return; }
+    for (unsigned i = 0; i < associativity; i++) {
+        block[i]->lines_changed(changed);
+    }
+    const machine::Cache::AccessRecord &access = cache->get_last_access();
+    if (access.valid) { ablock->set_access(access); }
+}
@@ -4,10 +4,13 @@
 #include "common/endian.h"
 #include "graphicsview.h"
 #include "machine/machine.h"
+#include "machine/memory/cache/cache.h"
 
 #include <QGraphicsObject>
 #include <QGraphicsScene>
 #include <QGraphicsView>
+#include <QTimer>
+#include <vector>
 
 class CacheAddressBlock : public QGraphicsObject {
     Q_OBJECT
@@ -21,16 +24,8 @@ public:
         const QStyleOptionGraphicsItem *option,
         QWidget *widget) override;
 
-private slots:
-    void cache_update(
-        unsigned associat,
-        unsigned set,
-        unsigned col,
-        bool valid,
-        bool dirty,
-        uint32_t tag,
-        const uint32_t *data,
-        bool write);
+    /** Show the address of the most recent access. */
+    void set_access(const machine::Cache::AccessRecord &access);
 
 private:
     unsigned rows, columns;
@@ -39,11 +34,14 @@ private:
     unsigned width;
 };
 
+/**
+ * Single way of the cache. Content of the lines is painted directly from the cache, so that the
+ * view does not hold a text item per cell and only changed rows are repainted.
+ */
 class CacheViewBlock : public QGraphicsObject {
     Q_OBJECT
 public:
     CacheViewBlock(const machine::Cache *cache, unsigned block, bool last);
-    ~CacheViewBlock() override;
 
     [[nodiscard]] QRectF boundingRect() const override;
 
@@ -52,25 +50,28 @@ public:
         const QStyleOptionGraphicsItem *option,
         QWidget *widget) override;
 
-private slots:
-    virtual void cache_update(
-        unsigned associat,
-        unsigned set,
-        unsigned col,
-        bool valid,
-        bool dirty,
-        uint32_t tag,
-        const uint32_t *data,
-        bool write);
+    /**
+     * Schedule repaint of changed rows and move the access highlight.
+     *
+     * @param changed   bitmap obtained from `Cache::take_changed_lines`
+     */
+    void lines_changed(const std::vector<bool> &changed);
 
 private:
+    void paint_row(QPainter *painter, unsigned row) const;
+    void update_row(unsigned row);
+
+    const machine::Cache *const cache;
     const Endian simulated_machine_endian;
     bool islast;
     unsigned block;
     unsigned rows, columns;
-    QGraphicsSimpleTextItem **validity, **dirty, **tag, ***data;
+    bool enabled;
+    bool dirty;
+    QFont font;
     unsigned curr_row;
     bool last_highlighted;
+    bool last_write;
     unsigned last_set;
     unsigned last_col;
 };
@@ -81,7 +82,14 @@ public:
     explicit CacheViewScene(const machine::Cache *cache);
     ~CacheViewScene() override;
 
+private slots:
+    void request_update();
+    /** Consume lines changed in the cache since the last frame. */
+    void update_lines();
+
 private:
+    const machine::Cache *const cache;
+    QTimer update_timer;
     unsigned associativity;
     CacheViewBlock **block;
     CacheAddressBlock *ablock;
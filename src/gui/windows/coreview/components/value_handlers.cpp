@@ -17,6 +17,9 @@ BoolValue::BoolValue(SimpleTextItem *const element, const bool &data)
     , data(data) {}
 
 void BoolValue::update() {
+    if (shown && shown_data == data) { return; }
+    shown_data = data;
+    shown = true;
     element->setText(data ? QStringLiteral("1") : QStringLiteral("0"));
 }
 
@@ -27,13 +30,18 @@ PCValue::PCValue(SimpleTextItem *element, const machine::Address &data)
 PCValue::PCValue(const PCValue &other)
     : QObject(other.parent())
     , element(other.element)
-    , data(other.data) {}
+    , data(other.data)
+    , shown_data(other.shown_data)
+    , shown(other.shown) {}
 
 void PCValue::clicked() {
     emit jump_to_pc(data);
 }
 
 void PCValue::update() {
+    if (shown && shown_data == data) { return; }
+    shown_data = data;
+    shown = true;
     element->setText(QString("0x%1").arg(data.get_raw(), 8, 16, QChar('0')));
 }
 
@@ -42,6 +50,9 @@ RegValue::RegValue(SimpleTextItem *element, const machine::RegisterValue &data)
     , data(data) {}
 
 void RegValue::update() {
+    if (shown && shown_data == data.as_u32()) { return; }
+    shown_data = data.as_u32();
+    shown = true;
     element->setText(QString("%1").arg(data.as_u32(), 8, 16, QChar('0')));
 }
 
@@ -50,6 +61,9 @@ RegIdValue::RegIdValue(svgscene::SimpleTextItem *element, const machine::Registe
     , data(data) {}
 
 void RegIdValue::update() {
+    if (shown && shown_data == data) { return; }
+    shown_data = data;
+    shown = true;
     element->setText(QString("%1").arg(data, 2, 10, QChar('0')));
 }
 
@@ -58,6 +72,9 @@ DebugValue::DebugValue(SimpleTextItem *element, const unsigned int &data)
     , data(data) {}
 
 void DebugValue::update() {
+    if (shown && shown_data == data) { return; }
+    shown_data = data;
+    shown = true;
     element->setText(QString("%1").arg(data, 0, 10, QChar(' ')));
 }
 MultiTextValue::MultiTextValue(SimpleTextItem *const element, Data data)
@@ -67,6 +84,9 @@ MultiTextValue::MultiTextValue(SimpleTextItem *const element, Data data)
     , originalBrush(element->brush()) {}
 
 void MultiTextValue::update() {
+    if (shown && shown_text_index == current_text_index) { return; }
+    shown_text_index = current_text_index;
+    shown = true;
     if (current_text_index != 0) {
         // Highlight non-default value.
         element->setBrush(Qt::red);
@@ -82,5 +102,11 @@ InstructionValue::InstructionValue(SimpleTextItem *const element, Data data)
     , address_data(data.second) {}
 
 void InstructionValue::update() {
+    if (shown && shown_instruction == instruction_data.data() && shown_address == address_data) {
+        return;
+    }
+    shown_instruction = instruction_data.data();
+    shown_address = address_data;
+    shown = true;
     element->setText(instruction_data.to_str(address_data));
 }
@@ -3,6 +3,9 @@
  * values that is read from provided source.
  *
  * Components accept different types and produce different formatting.
+ * Each component remembers the value it has shown last and touches the
+ * text item only when the value has changed. The first update always
+ * replaces the placeholder text from the SVG.
  *
  * @file
  */
@@ -29,6 +32,8 @@ public:
 private:
     BORROWED svgscene::SimpleTextItem *const element;
     const bool &data;
+    bool shown_data = false;
+    bool shown = false;
 };
 
 class PCValue : public QObject {
@@ -48,6 +53,8 @@ public:
 private:
     BORROWED svgscene::SimpleTextItem *const element;
     const machine::Address &data;
+    machine::Address shown_data;
+    bool shown = false;
 };
 
 class RegValue {
@@ -59,6 +66,8 @@ public:
 private:
     BORROWED svgscene::SimpleTextItem *const element;
     const machine::RegisterValue &data;
+    uint32_t shown_data = 0;
+    bool shown = false;
 };
 
 class RegIdValue {
@@ -70,6 +79,8 @@ public:
 private:
     BORROWED svgscene::SimpleTextItem *const element;
     const machine::RegisterId &data;
+    machine::RegisterId shown_data = 0;
+    bool shown = false;
 };
 
 class DebugValue {
@@ -81,6 +92,8 @@ public:
 private:
     BORROWED svgscene::SimpleTextItem *const element;
     const unsigned &data;
+    unsigned shown_data = 0;
+    bool shown = false;
 };
 
 class MultiTextValue {
@@ -97,6 +110,8 @@ private:
     const unsigned &current_text_index;
     Source &text_table;
     QBrush originalBrush;
+    unsigned shown_text_index = 0;
+    bool shown = false;
 };
 
 class InstructionValue {
@@ -111,6 +126,9 @@ private:
     BORROWED svgscene::SimpleTextItem *const element;
     const machine::Instruction &instruction_data;
     const machine::Address &address_data;
+    uint32_t shown_instruction = 0;
+    machine::Address shown_address;
+    bool shown = false;
 };
 
 template<typename SOURCE>
@@ -4,9 +4,12 @@
 #include "data.h"
 #include "machine/core.h"
 
+#include <QFile>
+#include <QHash>
+#include <algorithm>
 #include <svgscene/components/hyperlinkitem.h>
 #include <svgscene/components/simpletextitem.h>
-#include <svgscene/svghandler.h>
+#include <svgscene/svgcompiled.h>
 #include <unordered_map>
 #include <vector>
 
@@ -19,12 +22,39 @@ using svgscene::SvgDomTree;
 
 LOG_CATEGORY("gui.coreview");
 
+/**
+ * Schemas are compiled during the build (`svgscene-compiler`) and read without parsing the SVG.
+ * Where the compiled form is not available (cross-compiled builds), the SVG is parsed instead.
+ */
+static svgscene::CompiledSvg load_schema(const QString &core_svg_scheme_name) {
+    QFile compiled_file(QString(":/core/%1.svgc").arg(core_svg_scheme_name));
+    if (compiled_file.open(QIODevice::ReadOnly)) {
+        svgscene::CompiledSvg compiled = svgscene::CompiledSvg::fromCompiledFile(&compiled_file);
+        if (!compiled.isEmpty()) { return compiled; }
+        WARN("Compiled schema %s is not readable, parsing the SVG.",
+             qPrintable(core_svg_scheme_name));
+    }
+    return svgscene::CompiledSvg::fromFileName(QString(":/core/%1.svg").arg(core_svg_scheme_name));
+}
+
+/**
+ * Schemas are loaded only once per process. Scenes created on machine reload or when switching
+ * between core configurations are instantiated from the compiled form.
+ */
+static const svgscene::CompiledSvg &compiled_schema(const QString &core_svg_scheme_name) {
+    static QHash<QString, svgscene::CompiledSvg> schemas;
+    auto it = schemas.find(core_svg_scheme_name);
+    if (it == schemas.end()) {
+        it = schemas.insert(core_svg_scheme_name, load_schema(core_svg_scheme_name));
+    }
+    return *it;
+}
+
 CoreViewScene::CoreViewScene(machine::Machine *machine, const QString &core_svg_scheme_name)
     : SvgGraphicsScene()
     , program_counter_value((VALUE_SOURCE_NAME_MAPS.PC.at(QStringLiteral("fetch-pc")))(
           machine->core()->get_state())) {
-    SvgDocument document
-        = svgscene::parseFromFileName(this, QString(":/core/%1.svg").arg(core_svg_scheme_name));
+    SvgDocument document = compiled_schema(core_svg_scheme_name).instantiate(this);
 
     for (auto hyperlink_tree : document.getRoot().findAll<HyperlinkItem>()) {
         this->install_hyperlink(hyperlink_tree.getElement());
@@ -173,8 +203,11 @@ CoreViewScene::CoreViewScene(machine::Machine *machine, const QString &core_svg_
 
     update_values(); // Set to initial value - most often zero.
 
-    // Update coreview with each core step.
-    connect(machine->core(), &machine::Core::step_done, this, &CoreViewScene::update_values);
+    // Update coreview with core steps, at most once per frame.
+    update_timer.setSingleShot(true);
+    connect(&update_timer, &QTimer::timeout, this, &CoreViewScene::update_values);
+    connect(machine->core(), &machine::Core::step_done, this, &CoreViewScene::request_update);
+    connect(machine, &machine::Machine::batch_done, this, &CoreViewScene::request_update);
 }
 
 CoreViewScene::~CoreViewScene() = default;
@@ -225,6 +258,8 @@ void CoreViewScene::update_value_list(std::vector<T> &value_list) {
 }
 
 void CoreViewScene::update_values() {
+    last_update.start();
+    update_timer.stop();
     update_value_list(values.bool_values);
     update_value_list(values.debug_values);
     update_value_list(values.reg_values);
@@ -236,6 +271,14 @@ void CoreViewScene::update_values() {
     update_value_list(values.mux3_values);
 }
 
+void CoreViewScene::request_update() {
+    constexpr qint64 FRAME_INTERVAL_MS = 16;
+    if (update_timer.isActive()) { return; }
+    // The first change after an idle period is shown without delay.
+    const qint64 elapsed = last_update.isValid() ? last_update.elapsed() : FRAME_INTERVAL_MS;
+    update_timer.start(static_cast<int>(std::max<qint64>(0, FRAME_INTERVAL_MS - elapsed)));
+}
+
 void CoreViewScene::request_jump_to_program_counter_wrapper() {
     emit request_jump_to_program_counter(program_counter_value);
 }
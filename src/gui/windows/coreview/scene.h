@@ -6,9 +6,11 @@
 #include "common/polyfills/qstring_hash.h"
 #include "graphicsview.h"
 
+#include <QElapsedTimer>
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QSignalMapper>
+#include <QTimer>
 #include <machine/machine.h>
 #include <svgscene/components/hyperlinkitem.h>
 #include <svgscene/components/simpletextitem.h>
@@ -43,6 +45,11 @@ public slots:
      * @see install_value
      */
     void update_values();
+    /**
+     * Schedule update of values. Requests arriving faster than the display frame rate are
+     * coalesced, so the cost of the view does not grow with the simulation speed.
+     */
+    void request_update();
 
 protected:
     /**
@@ -103,6 +110,10 @@ protected:
 
     /** Reference to current PC value to be used to focus PC in program memory on lick */
     const machine::Address& program_counter_value;
+
+private:
+    QTimer update_timer;
+    QElapsedTimer last_update;
 };
 
 class CoreViewSceneSimple : public CoreViewScene {
@@ -43,6 +43,7 @@ const char *CsrDock::sizeHintText() {
 }
 
 void CsrDock::setup(machine::Machine *machine) {
+    controlst = nullptr;
     if (machine == nullptr) {
         // Reset data
         for (auto &i : csr_view) {
@@ -51,7 +52,7 @@ void CsrDock::setup(machine::Machine *machine) {
         return;
     }
 
-    const machine::CSR::ControlState *controlst = machine->control_state();
+    controlst = machine->control_state();
     if (controlst == nullptr)
         return;
 
@@ -72,6 +73,7 @@ void CsrDock::setup(machine::Machine *machine) {
     connect(controlst, &machine::CSR::ControlState::write_signal, this, &CsrDock::csr_changed);
     connect(controlst, &machine::CSR::ControlState::read_signal, this, &CsrDock::csr_read);
     connect(machine, &machine::Machine::tick, this, &CsrDock::clear_highlights);
+    connect(machine, &machine::Machine::post_tick, this, &CsrDock::refresh_all);
 }
 
 void CsrDock::csr_changed(size_t internal_reg_id, machine::RegisterValue val) {
@@ -98,6 +100,18 @@ void CsrDock::csr_read(size_t internal_reg_id, machine::RegisterValue val) {
     csr_highlighted_any = true;
 }
 
+void CsrDock::refresh_all() {
+    // Counters are incremented without write signal and no write signals are emitted during
+    // a batch, changed values are found by comparison once per tick.
+    if (controlst == nullptr) { return; }
+    for (size_t i = 0; i < machine::CSR::REGISTERS.size(); i++) {
+        uint64_t val = controlst->read_internal(i).as_xlen(xlen);
+        if (csr_view[i]->text() != QString("0x") + QString::number(val, 16)) {
+            csr_changed(i, val);
+        }
+    }
+}
+
 void CsrDock::clear_highlights() {
     if (!csr_highlighted_any) { return; }
     for (size_t i = 0; i < machine::CSR::REGISTERS.size(); i++) {
@@ -22,10 +22,12 @@ public:
 private slots:
     void csr_changed(std::size_t internal_reg_id, machine::RegisterValue val);
     void csr_read(std::size_t internal_reg_id, machine::RegisterValue val);
+    void refresh_all();
     void clear_highlights();
 
 private:
     machine::Xlen xlen;
+    const machine::CSR::ControlState *controlst = nullptr;
 
     const char *sizeHintText();
 
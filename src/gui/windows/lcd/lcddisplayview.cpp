@@ -11,26 +11,38 @@ LcdDisplayView::LcdDisplayView(QWidget *parent) : Super(parent) {
 }
 
 void LcdDisplayView::setup(machine::LcdDisplay *lcd_display) {
+    if (display != nullptr) { disconnect(display, nullptr, this, nullptr); }
+    display = lcd_display;
+    release_framebuffer();
     if (lcd_display == nullptr) { return; }
-    connect(lcd_display, &machine::LcdDisplay::pixel_update, this, &LcdDisplayView::pixel_update);
-    fb_pixels.reset(
-        new QImage(lcd_display->get_width(), lcd_display->get_height(), QImage::Format_RGB32));
-    fb_pixels->fill(qRgb(0, 0, 0));
+    connect(lcd_display, &machine::LcdDisplay::frame_update, this, &LcdDisplayView::frame_update);
+    // The image must not outlive the display, whose memory it refers to.
+    connect(lcd_display, &QObject::destroyed, this, &LcdDisplayView::release_framebuffer);
+    // The image shares the framebuffer memory of the display, no pixel conversion is done.
+    fb_pixels.reset(new QImage(
+        lcd_display->get_fb_data(), lcd_display->get_width(), lcd_display->get_height(),
+        lcd_display->get_fb_line_size(), QImage::Format_RGB16));
     update_scale();
     update();
 }
 
-void LcdDisplayView::pixel_update(size_t x, size_t y, uint r, uint g, uint b) {
+void LcdDisplayView::release_framebuffer() {
+    if (fb_pixels == nullptr) { return; }
+    fb_pixels.reset();
+    update_scale();
+    update();
+}
+
+void LcdDisplayView::frame_update(QRect dirty) {
     int x1, y1, x2, y2;
-    if (fb_pixels != nullptr) {
-        fb_pixels->setPixel(x, y, qRgb(r, g, b));
-        x1 = x * scale_x - 2;
+    if (fb_pixels != nullptr && !dirty.isEmpty()) {
+        x1 = dirty.left() * scale_x - 2;
         if (x1 < 0) { x1 = 0; }
-        x2 = x * scale_x + 2;
+        x2 = (dirty.right() + 1) * scale_x + 2;
         if (x2 > width()) { x2 = width(); }
-        y1 = y * scale_y - 2;
+        y1 = dirty.top() * scale_y - 2;
         if (y1 < 0) { y1 = 0; }
-        y2 = y * scale_y + 2;
+        y2 = (dirty.bottom() + 1) * scale_y + 2;
         if (y2 > height()) { y2 = height(); }
         update(x1, y1, x2 - x1, y2 - y1);
     }
@@ -5,6 +5,7 @@
 #include "machine/memory/backend/lcddisplay.h"
 
 #include <QImage>
+#include <QPointer>
 #include <QWidget>
 
 class LcdDisplayView : public QWidget {
@@ -20,7 +21,10 @@ public:
     uint fb_height();
 
 public slots:
-    void pixel_update(std::size_t x, std::size_t y, uint r, uint g, uint b);
+    void frame_update(QRect dirty);
+
+private slots:
+    void release_framebuffer();
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -30,7 +34,9 @@ private:
     void update_scale();
     float scale_x;
     float scale_y;
+    /** Refers to the framebuffer memory of `display`, released together with it. */
     Box<QImage> fb_pixels;
+    QPointer<machine::LcdDisplay> display;
 };
 
 #endif // LCDDISPLAYVIEW_H
@@ -1,9 +1,13 @@
 #include "memorymodel.h"
 
 #include <QBrush>
+#include <algorithm>
 
 using ae = machine::AccessEffects; // For enum values, the type is obvious from context.
 
+/** Rows read around the visible ones, so that small scrolls are served from the viewport. */
+constexpr int VIEWPORT_MARGIN_ROWS = 8;
+
 MemoryModel::MemoryModel(QObject *parent) : Super(parent), data_font("Monospace") {
     cell_size = CELLSIZE_WORD;
     cells_per_row = 1;
@@ -31,6 +35,14 @@ machine::FrontendMemory *MemoryModel::mem_access_rw() const {
     throw std::logic_error("No memory available on machine. This is u bug, please report it.");
 }
 
+const machine::FrontendMemory *MemoryModel::mem_shown() const {
+    if (machine == nullptr) { return nullptr; }
+    if ((access_through_cache > 0) && (machine->cache_data() != nullptr)) {
+        return machine->cache_data();
+    }
+    return mem_access();
+}
+
 int MemoryModel::rowCount(const QModelIndex & /*parent*/) const {
     return 750;
 }
@@ -67,18 +79,19 @@ QVariant MemoryModel::data(const QModelIndex &index, int role) const {
             return "0x" + s + t;
         }
         if (machine == nullptr) { return QString(""); }
-        mem = mem_access();
+        mem = mem_shown();
         if (mem == nullptr) { return QString(""); }
-        if ((access_through_cache > 0) && (machine->cache_data() != nullptr)) {
-            mem = machine->cache_data();
-        }
         address += cellSizeBytes() * (index.column() - 1);
         if (address < index0_offset) { return QString(""); }
-        switch (cell_size) {
-        case CELLSIZE_BYTE: data = mem->read_u8(address, ae::INTERNAL); break;
-        case CELLSIZE_HWORD: data = mem->read_u16(address, ae::INTERNAL); break;
-        default:
-        case CELLSIZE_WORD: data = mem->read_u32(address, ae::INTERNAL); break;
+        if (viewport.contains(address, cellSizeBytes())) {
+            data = viewport.read(address, cellSizeBytes());
+        } else {
+            switch (cell_size) {
+            case CELLSIZE_BYTE: data = mem->read_u8(address, ae::INTERNAL); break;
+            case CELLSIZE_HWORD: data = mem->read_u16(address, ae::INTERNAL); break;
+            default:
+            case CELLSIZE_WORD: data = mem->read_u32(address, ae::INTERNAL); break;
+            }
         }
 
         t = QString::number(data, 16);
@@ -104,7 +117,11 @@ QVariant MemoryModel::data(const QModelIndex &index, int role) const {
         address += cellSizeBytes() * (index.column() - 1);
         if (machine->cache_data() != nullptr) {
             machine::LocationStatus loc_stat;
-            loc_stat = machine->cache_data()->location_status(address);
+            if (viewport.contains(address, cellSizeBytes())) {
+                loc_stat = viewport.location_status(address);
+            } else {
+                loc_stat = machine->cache_data()->location_status(address);
+            }
             if (loc_stat & machine::LOCSTAT_DIRTY) {
                 QBrush bgd(Qt::yellow);
                 return bgd;
@@ -121,6 +138,7 @@ QVariant MemoryModel::data(const QModelIndex &index, int role) const {
 
 void MemoryModel::setup(machine::Machine *machine) {
     this->machine = machine;
+    viewport.invalidate();
     if (machine != nullptr) {
         connect(machine, &machine::Machine::post_tick, this, &MemoryModel::check_for_updates);
     }
@@ -136,6 +154,7 @@ void MemoryModel::setup(machine::Machine *machine) {
 void MemoryModel::setCellsPerRow(unsigned int cells) {
     beginResetModel();
     cells_per_row = cells;
+    viewport.invalidate();
     endResetModel();
 }
 
@@ -143,6 +162,7 @@ void MemoryModel::set_cell_size(int index) {
     beginResetModel();
     cell_size = (enum MemoryCellSize)index;
     index0_offset -= index0_offset.get_raw() % cellSizeBytes();
+    viewport.invalidate();
     endResetModel();
     emit cell_size_changed();
 }
@@ -156,9 +176,46 @@ void MemoryModel::update_all() {
             cache_data_change_counter = machine->cache_data()->get_change_counter();
         }
     }
+    refresh_viewport();
     emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
 }
 
+void MemoryModel::set_visible_rows(int first, int last) {
+    if (first == visible_first && last == visible_last) { return; }
+    visible_first = first;
+    visible_last = last;
+    // Newly exposed rows are painted by the view itself, the content of the viewport is only
+    // brought in sync with the memory.
+    if (mem_shown() != nullptr) { refresh_viewport(); }
+}
+
+QVector<MemoryViewport::RowRange> MemoryModel::refresh_viewport() {
+    const machine::FrontendMemory *mem = mem_shown();
+    if (mem == nullptr) {
+        viewport.invalidate();
+        return {};
+    }
+    int first = 0;
+    int last = rowCount() - 1;
+    if (visible_first <= visible_last) {
+        first = std::max(first, visible_first - VIEWPORT_MARGIN_ROWS);
+        last = std::min(last, visible_last + VIEWPORT_MARGIN_ROWS);
+    }
+    machine::Address start;
+    if (!get_row_address(start, first)) {
+        viewport.invalidate();
+        return {};
+    }
+    auto changed = viewport.refresh(
+        mem, machine->cache_data(), start, last - first + 1, cells_per_row * cellSizeBytes(),
+        cellSizeBytes());
+    for (auto &range : changed) {
+        range.first += first;
+        range.second += first;
+    }
+    return changed;
+}
+
 void MemoryModel::check_for_updates() {
     bool need_update = false;
     const machine::FrontendMemory *mem;
@@ -172,7 +229,17 @@ void MemoryModel::check_for_updates() {
         }
     }
     if (!need_update) { return; }
-    update_all();
+    if (!viewport.is_valid()) {
+        update_all();
+        return;
+    }
+    memory_change_counter = mem->get_change_counter();
+    if (machine->cache_data() != nullptr) {
+        cache_data_change_counter = machine->cache_data()->get_change_counter();
+    }
+    for (const auto &range : refresh_viewport()) {
+        emit dataChanged(index(range.first, 0), index(range.second, columnCount() - 1));
+    }
 }
 
 bool MemoryModel::adjustRowAndOffset(int &row, machine::Address address) {
@@ -227,6 +294,7 @@ bool MemoryModel::setData(const QModelIndex &index, const QVariant &value, int r
         default:
         case CELLSIZE_WORD: mem->write_u32(address, data, ae::INTERNAL); break;
         }
+        check_for_updates();
     }
     return true;
 }
@@ -2,6 +2,7 @@
 #define MEMORYMODEL_H
 
 #include "machine/machine.h"
+#include "memoryviewport.h"
 
 #include <QAbstractTableModel>
 #include <QFont>
@@ -30,6 +31,11 @@ public:
     setData(const QModelIndex &index, const QVariant &value, int role) override;
     bool adjustRowAndOffset(int &row, machine::Address address);
     void update_all();
+    /**
+     * Rows shown by the view. Memory around them is read as a single block on each update and
+     * only rows, which have changed, are reported to the view.
+     */
+    void set_visible_rows(int first, int last);
 
     void setCellsPerRow(unsigned int cells);
 
@@ -83,6 +89,10 @@ signals:
 private:
     [[nodiscard]] const machine::FrontendMemory *mem_access() const;
     [[nodiscard]] machine::FrontendMemory *mem_access_rw() const;
+    /** Memory the cells are read from (data bus or data cache). */
+    [[nodiscard]] const machine::FrontendMemory *mem_shown() const;
+    /** @return changed rows of the table */
+    QVector<MemoryViewport::RowRange> refresh_viewport();
     enum MemoryCellSize cell_size;
     unsigned int cells_per_row;
     machine::Address index0_offset;
@@ -91,6 +101,9 @@ private:
     uint32_t memory_change_counter;
     uint32_t cache_data_change_counter;
     int access_through_cache;
+    MemoryViewport viewport;
+    int visible_first = 0;
+    int visible_last = -1;
 };
 
 #endif // MEMORYMODEL_H
@@ -104,6 +104,16 @@ void MemoryTableView::set_cell_size(int index) {
     }
 }
 
+void MemoryTableView::update_visible_rows() {
+    auto *m = dynamic_cast<MemoryModel *>(model());
+    if (m == nullptr) { return; }
+    int first = rowAt(0);
+    int last = rowAt(viewport()->height() - 1);
+    if (first < 0) { return; }
+    if (last < 0) { last = m->rowCount() - 1; }
+    m->set_visible_rows(first, last);
+}
+
 void MemoryTableView::adjust_scroll_pos_check() {
     if (!adjust_scroll_pos_in_progress) {
         adjust_scroll_pos_in_progress = true;
@@ -143,6 +153,7 @@ void MemoryTableView::adjust_scroll_pos_process() {
         setCurrentIndex(m->index(prev_index.row() + row - prev_row, prev_index.column()));
         emit m->update_all();
     } while (false);
+    update_visible_rows();
     m->get_row_address(address, rowAt(0));
     addr0_save_change(address);
     emit address_changed(address);
@@ -162,6 +173,7 @@ void MemoryTableView::resizeEvent(QResizeEvent *event) {
     }
     Super::resizeEvent(event);
     adjustColumnCount();
+    update_visible_rows();
     if (keep_row0) {
         initial_address = machine::Address::null();
         go_to_address(address);
@@ -176,6 +188,7 @@ void MemoryTableView::go_to_address(machine::Address address) {
     scrollTo(m->index(row, 0), QAbstractItemView::PositionAtTop);
     setCurrentIndex(m->index(row, 1));
     addr0_save_change(address);
+    update_visible_rows();
     emit m->update_all();
 }
 
@@ -1,6 +1,7 @@
 #include "messagesmodel.h"
 
 #include <QBrush>
+#include <algorithm>
 #include <utility>
 
 class MessagesEntry {
@@ -27,7 +28,12 @@ public:
     QString hint;
 };
 
+/** Oldest messages are dropped above this count. */
+constexpr int MAX_MESSAGES = 10000;
+
 MessagesModel::MessagesModel(QObject *parent) : Super(parent) {
+    flush_timer.setSingleShot(true);
+    connect(&flush_timer, &QTimer::timeout, this, &MessagesModel::flush_pending);
 }
 
 MessagesModel::~MessagesModel() {
@@ -99,18 +105,37 @@ void MessagesModel::insert_line(
     int column,
     const QString &text,
     const QString &hint) {
-    beginInsertRows(QModelIndex(), rowCount(), rowCount());
-    messages.append(new MessagesEntry(type, file, line, column, text, hint));
+    pending.append(new MessagesEntry(type, file, line, column, text, hint));
+    if (pending.size() > MAX_MESSAGES) { delete pending.takeFirst(); }
+    if (!flush_timer.isActive()) { flush_timer.start(0); }
+}
+
+void MessagesModel::flush_pending() {
+    if (pending.isEmpty()) { return; }
+    const int excess = std::min(messages.size() + pending.size() - MAX_MESSAGES, messages.size());
+    if (excess > 0) {
+        beginRemoveRows(QModelIndex(), 0, excess - 1);
+        for (int i = 0; i < excess; i++) {
+            delete messages[i];
+        }
+        messages.remove(0, excess);
+        endRemoveRows();
+    }
+    beginInsertRows(QModelIndex(), rowCount(), rowCount() + pending.size() - 1);
+    messages.append(pending);
+    pending.clear();
     endInsertRows();
 }
 
 void MessagesModel::clear_messages() {
+    flush_timer.stop();
+    qDeleteAll(pending);
+    pending.clear();
     auto row_count = rowCount();
     if (row_count == 0) return;
     beginRemoveRows(QModelIndex(), 0, row_count - 1);
-    while (!messages.isEmpty()) {
-        delete messages.takeFirst();
-    }
+    qDeleteAll(messages);
+    messages.clear();
     endRemoveRows();
 }
 
@@ -5,6 +5,7 @@
 
 #include <QAbstractListModel>
 #include <QFont>
+#include <QTimer>
 #include <QVector>
 
 class MessagesEntry;
@@ -44,8 +45,14 @@ signals:
         QString text,
         QString hint);
 
+private slots:
+    /** Insert all lines reported since the last flush as a single batch of rows. */
+    void flush_pending();
+
 private:
     QVector<MessagesEntry *> messages;
+    QVector<MessagesEntry *> pending;
+    QTimer flush_timer;
 };
 
 #endif // MESSAGESMODEL_H
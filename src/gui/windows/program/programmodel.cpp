@@ -1,9 +1,15 @@
 #include "programmodel.h"
 
 #include <QtGui/qbrush.h>
+#include <algorithm>
 
 using ae = machine::AccessEffects; // For enum values, the type is obvious from context.
 
+/** Rows read around the visible ones, so that small scrolls are served from the viewport. */
+constexpr int VIEWPORT_MARGIN_ROWS = 8;
+/** Above this count of stage highlight changes the whole column is repainted. */
+constexpr int MAX_STAGE_ROWS = 64;
+
 ProgramModel::ProgramModel(QObject *parent) : Super(parent), data_font("Monospace") {
     index0_offset = machine::Address::null();
     data_font.setStyleHint(QFont::TypeWriter);
@@ -69,7 +75,9 @@ QVariant ProgramModel::data(const QModelIndex &index, int role) const {
         mem = mem_access();
         if (mem == nullptr) { return QString(" "); }
 
-        machine::Instruction inst(mem->read_u32(address));
+        const int viewport_row = viewport.row_of(address);
+        machine::Instruction inst(
+            viewport_row >= 0 ? viewport.read(address, 4) : mem->read_u32(address));
 
         switch (index.column()) {
         case 0:
@@ -82,7 +90,12 @@ QVariant ProgramModel::data(const QModelIndex &index, int role) const {
             t = QString::number(inst.data(), 16);
             s.fill('0', 8 - t.count());
             return s + t;
-        case 3: return inst.to_str(address);
+        case 3:
+            if (viewport_row < 0) { return inst.to_str(address); }
+            if (viewport_text[viewport_row].isNull()) {
+                viewport_text[viewport_row] = inst.to_str(address);
+            }
+            return viewport_text[viewport_row];
         default: return tr("");
         }
     }
@@ -91,7 +104,11 @@ QVariant ProgramModel::data(const QModelIndex &index, int role) const {
         if (!get_row_address(address, index.row()) || machine == nullptr) { return {}; }
         if (index.column() == 2 && machine->cache_program() != nullptr) {
             machine::LocationStatus loc_stat;
-            loc_stat = machine->cache_program()->location_status(address);
+            if (viewport.contains(address, cellSizeBytes())) {
+                loc_stat = viewport.location_status(address);
+            } else {
+                loc_stat = machine->cache_program()->location_status(address);
+            }
             if (loc_stat & machine::LOCSTAT_CACHED) {
                 QBrush bgd(Qt::lightGray);
                 return bgd;
@@ -119,6 +136,16 @@ QVariant ProgramModel::data(const QModelIndex &index, int role) const {
         }
         return {};
     }
+    if (role == Qt::ToolTipRole && (index.column() == 1 || index.column() == 3)) {
+        machine::Address address;
+        if (!get_row_address(address, index.row()) || machine == nullptr) { return {}; }
+        const machine::SymbolTable *symtab = machine->symbol_table();
+        QString symbol;
+        if (symtab == nullptr || !symtab->location_to_symbol_offset(symbol, address.get_raw())) {
+            return {};
+        }
+        return symbol;
+    }
     if (role == Qt::FontRole) { return data_font; }
     if (role == Qt::TextAlignmentRole) {
         if (index.column() == 0) { return Qt::AlignCenter; }
@@ -132,6 +159,9 @@ void ProgramModel::setup(machine::Machine *machine) {
     for (auto &i : stage_addr) {
         i = machine::STAGEADDR_NONE;
     }
+    stage_addr_changed.clear();
+    viewport.invalidate();
+    viewport_text.clear();
     if (machine != nullptr) {
         connect(machine, &machine::Machine::post_tick, this, &ProgramModel::check_for_updates);
     }
@@ -153,23 +183,103 @@ void ProgramModel::update_all() {
         }
     }
     stages_need_update = false;
+    stage_addr_changed.clear();
+    viewport_text.clear();
+    refresh_viewport();
     emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
 }
 
+void ProgramModel::set_visible_rows(int first, int last) {
+    if (first == visible_first && last == visible_last) { return; }
+    visible_first = first;
+    visible_last = last;
+    // Newly exposed rows are painted by the view itself, the content of the viewport is only
+    // brought in sync with the memory.
+    if (mem_access() != nullptr) { refresh_viewport(); }
+}
+
+QVector<MemoryViewport::RowRange> ProgramModel::refresh_viewport() {
+    const machine::FrontendMemory *mem = mem_access();
+    if (mem == nullptr) {
+        viewport.invalidate();
+        viewport_text.clear();
+        return {};
+    }
+    int first = 0;
+    int last = rowCount() - 1;
+    if (visible_first <= visible_last) {
+        first = std::max(first, visible_first - VIEWPORT_MARGIN_ROWS);
+        last = std::min(last, visible_last + VIEWPORT_MARGIN_ROWS);
+    }
+    machine::Address start;
+    if (!get_row_address(start, first)) {
+        viewport.invalidate();
+        viewport_text.clear();
+        return {};
+    }
+    const machine::Address prev_start = viewport.get_start();
+    const bool was_valid = viewport.is_valid();
+    auto changed = viewport.refresh(
+        mem, machine->cache_program(), start, last - first + 1, cellSizeBytes(), cellSizeBytes());
+    if (!was_valid || prev_start != start || viewport_text.size() != last - first + 1) {
+        viewport_text = QVector<QString>(last - first + 1);
+    } else {
+        for (const auto &range : changed) {
+            for (int row = range.first; row <= range.second; row++) {
+                viewport_text[row] = QString();
+            }
+        }
+    }
+    for (auto &range : changed) {
+        range.first += first;
+        range.second += first;
+    }
+    return changed;
+}
+
+void ProgramModel::emit_stage_rows() {
+    if (stage_addr_changed.size() > MAX_STAGE_ROWS) {
+        emit dataChanged(index(0, 3), index(rowCount() - 1, 3));
+        stage_addr_changed.clear();
+        return;
+    }
+    for (auto address : stage_addr_changed) {
+        int row;
+        if (get_row_for_address(row, address) && row < rowCount()) {
+            emit dataChanged(index(row, 3), index(row, 3));
+        }
+    }
+    stage_addr_changed.clear();
+}
+
 void ProgramModel::check_for_updates() {
-    bool need_update = stages_need_update;
+    bool need_update = false;
     const machine::FrontendMemory *mem;
     mem = mem_access();
     if (mem == nullptr) { return; }
 
     if (memory_change_counter != mem->get_change_counter()) { need_update = true; }
-    if (machine->cache_data() != nullptr) {
+    if (machine->cache_program() != nullptr) {
         if (cache_program_change_counter != machine->cache_program()->get_change_counter()) {
             need_update = true;
         }
     }
+    if (stages_need_update) {
+        stages_need_update = false;
+        emit_stage_rows();
+    }
     if (!need_update) { return; }
-    update_all();
+    if (!viewport.is_valid()) {
+        update_all();
+        return;
+    }
+    memory_change_counter = mem->get_change_counter();
+    if (machine->cache_program() != nullptr) {
+        cache_program_change_counter = machine->cache_program()->get_change_counter();
+    }
+    for (const auto &range : refresh_viewport()) {
+        emit dataChanged(index(range.first, 0), index(range.second, columnCount() - 1));
+    }
 }
 
 bool ProgramModel::adjustRowAndOffset(int &row, machine::Address address) {
@@ -201,7 +311,7 @@ void ProgramModel::toggle_hw_break(const QModelIndex &index) {
     } else {
         machine->insert_hwbreak(address);
     }
-    update_all();
+    emit dataChanged(index, index);
 }
 
 Qt::ItemFlags ProgramModel::flags(const QModelIndex &index) const {
@@ -238,6 +348,7 @@ bool ProgramModel::setData(const QModelIndex &index, const QVariant &value, int
             break;
         default: return false;
         }
+        check_for_updates();
     }
     return true;
 }
@@ -245,6 +356,10 @@ bool ProgramModel::setData(const QModelIndex &index, const QVariant &value, int
 void ProgramModel::update_stage_addr(uint stage, machine::Address addr) {
     if (stage < STAGEADDR_COUNT) {
         if (stage_addr[stage] != addr) {
+            if (stage_addr_changed.size() <= MAX_STAGE_ROWS) {
+                stage_addr_changed.append(stage_addr[stage]);
+                stage_addr_changed.append(addr);
+            }
             stage_addr[stage] = addr;
             stages_need_update = true;
         }
@@ -2,6 +2,7 @@
 #define PROGRAMMODEL_H
 
 #include "machine/machine.h"
+#include "memoryviewport.h"
 
 #include <QAbstractTableModel>
 #include <QFont>
@@ -23,6 +24,11 @@ public:
     bool
     setData(const QModelIndex &index, const QVariant &value, int role) override;
     bool adjustRowAndOffset(int &row, machine::Address address);
+    /**
+     * Rows shown by the view. Instructions around them are read as a single block on each update,
+     * their disassembly is kept until the instruction word changes.
+     */
+    void set_visible_rows(int first, int last);
 
     [[nodiscard]] inline const QFont *getFont() const {
         return &data_font;
@@ -73,6 +79,9 @@ public slots:
 private:
     [[nodiscard]] const machine::FrontendMemory *mem_access() const;
     [[nodiscard]] machine::FrontendMemory *mem_access_rw() const;
+    /** @return changed rows of the table */
+    QVector<MemoryViewport::RowRange> refresh_viewport();
+    void emit_stage_rows();
     machine::Address index0_offset;
     QFont data_font;
     machine::Machine *machine;
@@ -80,6 +89,13 @@ private:
     uint32_t cache_program_change_counter;
     machine::Address stage_addr[STAGEADDR_COUNT] {};
     bool stages_need_update;
+    /** Addresses which have gained or lost stage highlight since the last update. */
+    QVector<machine::Address> stage_addr_changed;
+    MemoryViewport viewport;
+    /** Disassembly of viewport rows, null string when not yet computed. */
+    mutable QVector<QString> viewport_text;
+    int visible_first = 0;
+    int visible_last = -1;
 };
 
 #endif // PROGRAMMODEL_H
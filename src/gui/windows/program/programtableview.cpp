@@ -77,6 +77,16 @@ void ProgramTableView::adjustColumnCount() {
     }
 }
 
+void ProgramTableView::update_visible_rows() {
+    auto *m = dynamic_cast<ProgramModel *>(model());
+    if (m == nullptr) { return; }
+    int first = rowAt(0);
+    int last = rowAt(viewport()->height() - 1);
+    if (first < 0) { return; }
+    if (last < 0) { last = m->rowCount() - 1; }
+    m->set_visible_rows(first, last);
+}
+
 void ProgramTableView::adjust_scroll_pos_check() {
     if (!adjust_scroll_pos_in_progress) {
         adjust_scroll_pos_in_progress = true;
@@ -116,6 +126,7 @@ void ProgramTableView::adjust_scroll_pos_process() {
         setCurrentIndex(m->index(prev_index.row() + row - prev_row, prev_index.column()));
         emit m->update_all();
     } while (false);
+    update_visible_rows();
     m->get_row_address(address, rowAt(0));
     if (need_addr0_save) { addr0_save_change(address); }
     emit address_changed(address.get_raw());
@@ -135,6 +146,7 @@ void ProgramTableView::resizeEvent(QResizeEvent *event) {
     }
     Super::resizeEvent(event);
     adjustColumnCount();
+    update_visible_rows();
     if (keep_row0) {
         initial_address = machine::Address::null();
         go_to_address(address);
@@ -149,6 +161,7 @@ void ProgramTableView::go_to_address_priv(machine::Address address) {
     scrollTo(m->index(row, 0), QAbstractItemView::PositionAtTop);
     setCurrentIndex(m->index(row, 1));
     if (need_addr0_save) { addr0_save_change(address); }
+    update_visible_rows();
     emit m->update_all();
 }
 
@@ -35,6 +35,8 @@ private:
     void go_to_address_priv(machine::Address address);
     void addr0_save_change(machine::Address val);
     void adjustColumnCount();
+    /** Tell the model which rows are shown, so it can keep just them up to date. */
+    void update_visible_rows();
     QSettings *settings;
 
     machine::Address initial_address;
@@ -49,6 +49,7 @@ QLabel *RegistersDock::addRegisterLabel(const QString &title) {
 }
 
 void RegistersDock::connectToMachine(machine::Machine *machine) {
+    regs = nullptr;
     if (machine == nullptr) {
         // Reset data
         pc->setText("");
@@ -58,7 +59,7 @@ void RegistersDock::connectToMachine(machine::Machine *machine) {
         return;
     }
 
-    const machine::Registers *regs = machine->registers();
+    regs = machine->registers();
 
     // if xlen changes adjust space to show full value
     if (xlen != machine->config().get_simulated_xlen()) {
@@ -81,6 +82,7 @@ void RegistersDock::connectToMachine(machine::Machine *machine) {
     connect(regs, &machine::Registers::gp_update, this, &RegistersDock::gp_changed);
     connect(regs, &machine::Registers::gp_read, this, &RegistersDock::gp_read);
     connect(machine, &machine::Machine::tick, this, &RegistersDock::clear_highlights);
+    connect(machine, &machine::Machine::batch_done, this, &RegistersDock::refresh_all);
 }
 
 void RegistersDock::pc_changed(machine::Address val) {
@@ -101,6 +103,20 @@ void RegistersDock::gp_read(machine::RegisterId i, machine::RegisterValue val) {
     }
 }
 
+void RegistersDock::refresh_all() {
+    // Registers do not report writes during a batch, changed values are found by comparison.
+    if (regs == nullptr) { return; }
+    pc_changed(regs->read_pc());
+    for (size_t i = 0; i < gp.size(); i++) {
+        const QString previous = gp[i]->text();
+        setRegisterValueToLabel(gp[i], regs->read_gp(i));
+        if (gp[i]->text() != previous) {
+            gp[i]->setPalette(pal_updated);
+            gp_highlighted[i] = true;
+        }
+    }
+}
+
 void RegistersDock::clear_highlights() {
     if (gp_highlighted.any()) {
         for (size_t i = 0; i < gp.size(); i++) {
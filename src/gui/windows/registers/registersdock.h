@@ -28,9 +28,11 @@ private slots:
     void gp_changed(machine::RegisterId i, machine::RegisterValue val);
     void gp_read(machine::RegisterId i, machine::RegisterValue val);
     void clear_highlights();
+    void refresh_all();
 
 private:
     machine::Xlen xlen;
+    const machine::Registers *regs {};
 
     const char *sizeHintText();
 
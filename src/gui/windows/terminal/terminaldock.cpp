@@ -6,26 +6,48 @@
 #include <QTextBlock>
 #include <QTextCursor>
 
-TerminalDock::TerminalDock(QWidget *parent, QSettings *settings) : QDockWidget(parent) {
-    (void)settings;
+/** Output is coalesced and shown at most once per this interval. */
+constexpr int FLUSH_INTERVAL_MS = 16;
+
+TerminalDock::TerminalDock(QWidget *parent, QSettings *settings)
+    : QDockWidget(parent)
+    , settings(settings) {
+    scrollback_lines = qMax(settings->value("TerminalScrollback", 10000).toInt(), 0);
     top_widget = new QWidget(this);
     setWidget(top_widget);
     layout_box = new QVBoxLayout(top_widget);
 
     terminal_text = new QTextEdit(top_widget);
     terminal_text->setMinimumSize(30, 30);
+    // Oldest blocks (lines) are removed by the document itself.
+    terminal_text->document()->setMaximumBlockCount(scrollback_lines);
     layout_box->addWidget(terminal_text);
     append_cursor.reset(new QTextCursor(terminal_text->document()));
     layout_bottom_box = new QHBoxLayout();
     layout_bottom_box->addWidget(new QLabel("Input:"));
     input_edit = new QLineEdit();
     layout_bottom_box->addWidget(input_edit);
+    layout_bottom_box->addWidget(new QLabel("Scrollback:"));
+    scrollback_edit = new QSpinBox();
+    scrollback_edit->setRange(0, 1000000);
+    scrollback_edit->setSingleStep(1000);
+    scrollback_edit->setSpecialValueText("unlimited");
+    scrollback_edit->setSuffix(" lines");
+    scrollback_edit->setToolTip("Number of lines kept in the terminal, older lines are removed.");
+    scrollback_edit->setValue(scrollback_lines);
+    layout_bottom_box->addWidget(scrollback_edit);
     layout_box->addLayout(layout_bottom_box);
     // insert newline on enter (it will be displayed as space)
     connect(input_edit, &QLineEdit::returnPressed, [this]() {
         input_edit->setText(input_edit->text() + '\n');
     });
 
+    flush_timer.setSingleShot(true);
+    connect(&flush_timer, &QTimer::timeout, this, &TerminalDock::flush_output);
+    connect(
+        scrollback_edit, QOverload<int>::of(&QSpinBox::valueChanged), this,
+        &TerminalDock::set_scrollback_lines);
+
     setObjectName("Terminal");
     setWindowTitle("Terminal");
 }
@@ -40,12 +62,41 @@ void TerminalDock::setup(machine::SerialPort *ser_port) {
 }
 
 void TerminalDock::tx_byte(unsigned int data) {
-    bool at_end = terminal_text->textCursor().atEnd();
-    if (data == '\n') {
-        append_cursor->insertBlock();
-    } else {
-        append_cursor->insertText(QString(QChar(data)));
+    queue_output(QByteArray(1, char(data)));
+}
+
+void TerminalDock::tx_byte(int fd, unsigned int data) {
+    (void)fd;
+    tx_byte(data);
+}
+
+void TerminalDock::tx_bytes(int fd, const QByteArray &data) {
+    (void)fd;
+    queue_output(data);
+}
+
+void TerminalDock::queue_output(const QByteArray &data) {
+    pending_output.append(data);
+    pending_lines += data.count('\n');
+    if (scrollback_lines > 0 && pending_lines > 2 * scrollback_lines) {
+        // Drop lines which would be trimmed from the scrollback right after the flush anyway.
+        int pos = pending_output.size();
+        for (int kept = 0; kept <= scrollback_lines; kept++) {
+            pos = pending_output.lastIndexOf('\n', pos - 1);
+        }
+        pending_output.remove(0, pos + 1);
+        pending_lines = scrollback_lines;
     }
+    if (!flush_timer.isActive()) { flush_timer.start(FLUSH_INTERVAL_MS); }
+}
+
+void TerminalDock::flush_output() {
+    if (pending_output.isEmpty()) { return; }
+    bool at_end = terminal_text->textCursor().atEnd();
+    // Line feeds are converted to block separators by the cursor.
+    append_cursor->insertText(QString::fromLatin1(pending_output));
+    pending_output.clear();
+    pending_lines = 0;
     if (at_end) {
         QTextCursor cursor = QTextCursor(terminal_text->document());
         cursor.movePosition(QTextCursor::End);
@@ -53,9 +104,11 @@ void TerminalDock::tx_byte(unsigned int data) {
     }
 }
 
-void TerminalDock::tx_byte(int fd, unsigned int data) {
-    (void)fd;
-    tx_byte(data);
+void TerminalDock::set_scrollback_lines(int lines) {
+    scrollback_lines = qMax(lines, 0);
+    // Lowering the limit removes the oldest lines immediately.
+    terminal_text->document()->setMaximumBlockCount(scrollback_lines);
+    settings->setValue("TerminalScrollback", scrollback_lines);
 }
 
 void TerminalDock::rx_byte_pool(int fd, unsigned int &data, bool &available) {
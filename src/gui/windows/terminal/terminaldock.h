@@ -7,8 +7,11 @@
 #include <QFormLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QSettings>
+#include <QSpinBox>
 #include <QTextCursor>
 #include <QTextEdit>
+#include <QTimer>
 
 class TerminalDock : public QDockWidget {
     Q_OBJECT
@@ -20,9 +23,18 @@ public:
 public slots:
     void tx_byte(unsigned int data);
     void tx_byte(int fd, unsigned int data);
+    void tx_bytes(int fd, const QByteArray &data);
     void rx_byte_pool(int fd, unsigned int &data, bool &available);
 
+private slots:
+    /** Append all output received since the last flush to the terminal at once. */
+    void flush_output();
+    /** Change the number of lines kept in the terminal (0 for unlimited) and store it. */
+    void set_scrollback_lines(int lines);
+
 private:
+    void queue_output(const QByteArray &data);
+
     QVBoxLayout *layout_box;
     QHBoxLayout *layout_bottom_box;
     QWidget *top_widget, *top_form {};
@@ -30,6 +42,14 @@ private:
     QTextEdit *terminal_text;
     Box<QTextCursor> append_cursor;
     QLineEdit *input_edit;
+    QSpinBox *scrollback_edit;
+    QSettings *settings;
+    /** Output not yet shown, it is flushed once per frame. */
+    QByteArray pending_output;
+    int pending_lines = 0;
+    /** Number of lines kept in the terminal, 0 means unlimited (setting `TerminalScrollback`). */
+    int scrollback_lines;
+    QTimer flush_timer;
 };
 
 #endif // TERMINALDOCK_H
@@ -0,0 +1,44 @@
+#include "terminaldock.test.h"
+
+#include "terminaldock.h"
+
+#include <QTemporaryDir>
+
+static void send_lines(TerminalDock &dock, int first, int last) {
+    for (int i = first; i <= last; i++) {
+        dock.tx_bytes(1, QString("line %1\n").arg(i).toLatin1());
+    }
+    // Output is shown by a timer, flush it right away.
+    QVERIFY(QMetaObject::invokeMethod(&dock, "flush_output"));
+}
+
+void TestTerminalDock::terminaldock_scrollback() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QSettings settings(dir.filePath("settings.ini"), QSettings::IniFormat);
+    settings.setValue("TerminalScrollback", 3);
+
+    TerminalDock dock(nullptr, &settings);
+    auto *text = dock.findChild<QTextEdit *>();
+    auto *scrollback = dock.findChild<QSpinBox *>();
+    QVERIFY(text != nullptr);
+    QVERIFY(scrollback != nullptr);
+    QCOMPARE(scrollback->value(), 3);
+
+    // Empty block after the last line feed counts as a line.
+    send_lines(dock, 0, 9);
+    QCOMPARE(text->toPlainText(), QString("line 8\nline 9\n"));
+
+    // Lowering the limit trims the shown lines immediately.
+    scrollback->setValue(2);
+    QCOMPARE(text->toPlainText(), QString("line 9\n"));
+    QCOMPARE(settings.value("TerminalScrollback").toInt(), 2);
+
+    // No lines are removed when unlimited.
+    scrollback->setValue(0);
+    send_lines(dock, 10, 12);
+    QCOMPARE(text->toPlainText(), QString("line 9\nline 10\nline 11\nline 12\n"));
+    QCOMPARE(settings.value("TerminalScrollback").toInt(), 0);
+}
+
+QTEST_MAIN(TestTerminalDock)
@@ -0,0 +1,13 @@
+#ifndef TERMINALDOCK_TEST_H
+#define TERMINALDOCK_TEST_H
+
+#include <QtTest>
+
+class TestTerminalDock : public QObject {
+    Q_OBJECT
+
+private slots:
+    static void terminaldock_scrollback();
+};
+
+#endif // TERMINALDOCK_TEST_H
@@ -50,13 +50,25 @@ Core::Core(Registers *regs,
 
 void Core::step(bool skip_break) {
     state.cycle_count++;
-    do_step(skip_break);
-    emit step_done(state);
+    if (wfi_waiting) { wfi_waiting = !control_state->core_interrupt_pending(); }
+    if (wfi_waiting) {
+        // Core is stalled by WFI, only time passes.
+        control_state->increment_cycle();
+    } else {
+        do_step(skip_break);
+    }
+    if (step_notification) { emit step_done(state); }
+}
+
+void Core::set_step_notification(bool enable) {
+    step_notification = enable;
 }
 
 void Core::reset() {
     state.cycle_count = 0;
     state.stall_count = 0;
+    wfi_waiting = false;
+    idle_loop_reset();
     do_reset();
 }
 
@@ -125,6 +137,56 @@ Xlen Core::get_xlen() const {
     return xlen;
 }
 
+bool Core::is_idle() const {
+    return wfi_waiting || idle_loop.stationary_iterations >= 2;
+}
+
+void Core::set_idle_detection(bool enable) {
+    idle_detection = enable;
+    idle_loop_reset();
+}
+
+void Core::idle_loop_reset() {
+    idle_loop.start = Address::null();
+    idle_loop.end = Address::null();
+    idle_loop.loaded_regs = 0;
+    idle_loop.side_effect = false;
+    idle_loop.stationary_iterations = 0;
+}
+
+void Core::idle_loop_update(
+    Address inst_addr,
+    Address next_inst_addr,
+    bool side_effect,
+    RegisterId loaded_reg) {
+    // Only tight polling loops are considered, longer ones are unlikely to be stationary.
+    constexpr int64_t MAX_LOOP_SIZE = 64;
+
+    if (!idle_loop.end.is_null() && (inst_addr < idle_loop.start || idle_loop.end < inst_addr)) {
+        idle_loop_reset();
+    }
+    idle_loop.side_effect |= side_effect;
+    if (loaded_reg != 0) { idle_loop.loaded_regs |= 1U << size_t(loaded_reg); }
+
+    if (next_inst_addr <= inst_addr && inst_addr - next_inst_addr <= MAX_LOOP_SIZE) {
+        const auto &gp = regs->read_gp_all();
+        if (inst_addr == idle_loop.end && next_inst_addr == idle_loop.start) {
+            bool stationary = !idle_loop.side_effect;
+            for (size_t i = 1; stationary && i < REGISTER_COUNT; i++) {
+                stationary = gp[i] == idle_loop.gp_start[i] || (idle_loop.loaded_regs & (1U << i));
+            }
+            idle_loop.stationary_iterations = stationary ? idle_loop.stationary_iterations + 1 : 0;
+        } else {
+            idle_loop.start = next_inst_addr;
+            idle_loop.end = inst_addr;
+            idle_loop.stationary_iterations = 0;
+        }
+        idle_loop.gp_start = gp;
+        idle_loop.loaded_regs = 0;
+        idle_loop.side_effect = false;
+    }
+}
+
 void Core::register_exception_handler(ExceptionCause excause, ExceptionHandler *exhandler) {
     if (excause == EXCAUSE_NONE) {
         ex_default_handler.reset(exhandler);
@@ -150,6 +212,9 @@ bool Core::handle_exception(
 
     if (excause == EXCAUSE_HWBREAK) { regs->write_pc(inst_addr); }
 
+    wfi_waiting = false;
+    idle_loop_reset();
+
     if (control_state != nullptr) {
         control_state->write_internal(CSR::Id::MEPC, inst_addr.get_raw());
         control_state->update_exception_cause(excause);
@@ -284,7 +349,7 @@ FetchState Core::fetch(PCInterstage pc, bool skip_break) {
     if (!skip_break && hw_breaks.contains(inst_addr)) { excause = EXCAUSE_HWBREAK; }
 
     if (control_state != nullptr) {
-        control_state->increment_internal(CSR::Id::MCYCLE, 1);
+        control_state->increment_cycle();
     }
 
     if (control_state != nullptr && excause == EXCAUSE_NONE) {
@@ -327,8 +392,13 @@ DecodeState Core::decode(const FetchInterstage &dt) {
     const bool regwrite = flags & IMF_REGWRITE;
 
     CSR::Address csr_address = (flags & IMF_CSR) ? dt.inst.csr_address() : CSR::Address(0);
-    RegisterValue csr_read_val
-        = ((control_state != nullptr && (flags & IMF_CSR))) ? control_state->read(csr_address) : 0;
+    // CSR address is translated only once here, later stages use the internal id.
+    size_t csr_id = 0;
+    RegisterValue csr_read_val = 0;
+    if (control_state != nullptr && (flags & IMF_CSR)) {
+        csr_id = CSR::ControlState::get_register_internal_id(csr_address);
+        csr_read_val = control_state->read_by_id(csr_id);
+    }
     bool csr_write = (flags & IMF_CSR) && (!(flags & IMF_CSR_TO_ALU) || (num_rs != 0));
 
     if ((flags & IMF_EXCEPTION) && (excause == EXCAUSE_NONE)) {
@@ -359,6 +429,7 @@ DecodeState Core::decode(const FetchInterstage &dt) {
                                 .immediate_val = immediate_val,
                                 .csr_read_val = csr_read_val,
                                 .csr_address = csr_address,
+                                .csr_id = csr_id,
                                 .excause = excause,
                                 .ff_rs = FORWARD_NONE,
                                 .ff_rt = FORWARD_NONE,
@@ -388,6 +459,7 @@ DecodeState Core::decode(const FetchInterstage &dt) {
                                 .csr_to_alu = bool(flags & IMF_CSR_TO_ALU),
                                 .csr_write = csr_write,
                                 .xret = bool(flags & IMF_XRET),
+                                .wfi = bool(flags & IMF_WFI),
                                 .insert_stall_before = bool(flags & IMF_CSR) } };
 }
 
@@ -442,6 +514,7 @@ ExecuteState Core::execute(const DecodeInterstage &dt) {
                  .immediate_val = dt.immediate_val,
                  .csr_read_val = dt.csr_read_val,
                  .csr_address = dt.csr_address,
+                 .csr_id = dt.csr_id,
                  .excause = excause,
                  .memctl = dt.memctl,
                  .num_rd = dt.num_rd,
@@ -457,6 +530,7 @@ ExecuteState Core::execute(const DecodeInterstage &dt) {
                  .csr = dt.csr,
                  .csr_write = dt.csr_write,
                  .xret = dt.xret,
+                 .wfi = dt.wfi,
              } };
 }
 
@@ -497,9 +571,9 @@ MemoryState Core::memory(const ExecuteInterstage &dt) {
 
     bool csr_written = false;
     if (control_state != nullptr && dt.is_valid && dt.excause == EXCAUSE_NONE) {
-        control_state->increment_internal(CSR::Id::MINSTRET, 1);
+        control_state->increment_instret();
         if (dt.csr_write) {
-            control_state->write(dt.csr_address, dt.alu_val);
+            control_state->write_by_id(dt.csr_id, dt.alu_val);
             csr_written = true;
         }
         if (dt.xret) {
@@ -510,6 +584,18 @@ MemoryState Core::memory(const ExecuteInterstage &dt) {
                 computed_next_inst_addr = Address(control_state->read_internal(CSR::Id::MEPC).as_u64());
             csr_written = true;
         }
+        if (dt.wfi) {
+            // Without any enabled interrupt WFI could never be woken up, treat it as NOP then.
+            wfi_waiting = control_state->read_internal(CSR::Id::MIE) != 0
+                          && !control_state->core_interrupt_pending();
+        }
+    }
+
+    if (idle_detection && dt.is_valid) {
+        idle_loop_update(
+            dt.inst_addr, computed_next_inst_addr,
+            excause != EXCAUSE_NONE || memwrite || csr_written || dt.wfi,
+            (memread && regwrite) ? dt.num_rd : RegisterId(0));
     }
 
     return { MemoryInternalState {
@@ -65,6 +65,17 @@ public:
      */
     uint64_t get_xlen_from_reg(RegisterValue reg) const;
 
+    /**
+     * Core cannot make any progress until an interrupt arrives. It is either stalled by WFI or
+     * (when idle detection is enabled) it spins in a short loop without any side effects.
+     * Machine uses this to skip simulated time to the next timer event.
+     */
+    bool is_idle() const;
+    /** Enable tracking of side effect free loops reported by `is_idle`. */
+    void set_idle_detection(bool enable);
+    /** Emit `step_done` after each step (default). */
+    void set_step_notification(bool enable);
+
 protected:
     CoreState state {};
 
@@ -120,6 +131,31 @@ protected:
     QMap<ExceptionCause, OWNED ExceptionHandler *> ex_handlers;
     Box<ExceptionHandler> ex_default_handler;
 
+    /** WFI has been retired and no enabled interrupt is pending yet. */
+    bool wfi_waiting = false;
+    bool idle_detection = false;
+    bool step_notification = true;
+    /**
+     * Last iteration of a short backward loop. The loop is stationary when an iteration has not
+     * written memory nor CSRs and all registers, which differ from the start of the iteration,
+     * were loaded from memory (e.g. polling of a device register or mtime).
+     */
+    struct {
+        Address start;
+        Address end;
+        array<RegisterValue, REGISTER_COUNT> gp_start;
+        uint32_t loaded_regs;
+        bool side_effect;
+        unsigned stationary_iterations;
+    } idle_loop {};
+
+    void idle_loop_reset();
+    void idle_loop_update(
+        Address inst_addr,
+        Address next_inst_addr,
+        bool side_effect,
+        RegisterId loaded_reg);
+
     FetchState fetch(PCInterstage pc, bool skip_break);
     DecodeState decode(const FetchInterstage &);
     static ExecuteState execute(const DecodeInterstage &);
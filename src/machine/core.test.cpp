@@ -1104,4 +1104,44 @@ void TestCore::pipecore_extension_m() {
     test_program_with_single_result<CorePipelined>();
 }
 
+// Privileged
+
+template<typename Core>
+void test_wfi() {
+    Registers registers {};
+    Memory memory_backend(BIG);
+    TrivialBus memory(&memory_backend);
+    FalsePredictor predictor {};
+    CSR::ControlState controlst {};
+    Core core(&registers, &predictor, &memory, &memory, &controlst, Xlen::_32, config_isa_word_default);
+
+    vector<QString> instructions { "addi x1, x0, 128", "csrrw x0, mie, x1", "wfi",
+                                   "addi x10, x0, 1" };
+    instructions.insert(instructions.end(), 8, "nop");
+    compile_simple_program(memory, 0x200_addr, instructions);
+
+    // Enough steps to retire WFI in both cores, the core has to stay stalled afterwards.
+    for (int i = 0; i < 12; i++) {
+        core.step();
+    }
+    QVERIFY(core.is_idle());
+    QCOMPARE(registers.read_gp(10), RegisterValue(0));
+
+    // Pending enabled interrupt wakes the core even with interrupts globally disabled.
+    controlst.set_interrupt_signal(7, true);
+    for (int i = 0; i < 4; i++) {
+        core.step();
+    }
+    QVERIFY(!core.is_idle());
+    QCOMPARE(registers.read_gp(10), RegisterValue(1));
+}
+
+void TestCore::singlecore_wfi() {
+    test_wfi<CoreSingle>();
+}
+
+void TestCore::pipecore_wfi() {
+    test_wfi<CorePipelined>();
+}
+
 QTEST_APPLESS_MAIN(TestCore)
@@ -45,6 +45,10 @@ private slots:
     void pipecore_extension_m_data();
     void singlecore_extension_m();
     void pipecore_extension_m();
+
+    // Privileged
+    void singlecore_wfi();
+    void pipecore_wfi();
 };
 
 #endif // CORE_TEST_H
@@ -20,12 +20,17 @@ namespace machine { namespace CSR {
 
     ControlState::ControlState(const ControlState &other)
         : QObject(this->parent())
-        , xlen(other.xlen), register_data(other.register_data) {}
+        , xlen(other.xlen), register_data(other.register_data)
+        , interrupt_request(other.interrupt_request)
+        , cycle_count(other.cycle_count)
+        , instret_count(other.instret_count) {}
 
     void ControlState::reset() {
         std::transform(
             REGISTERS.begin(), REGISTERS.end(), register_data.begin(),
             [](const RegisterDesc &desc) { return desc.initial_value; });
+        cycle_count = register_data[Id::MCYCLE].as_u64();
+        instret_count = register_data[Id::MINSTRET].as_u64();
 
         uint64_t misa = read_internal(CSR::Id::MISA).as_u64();
         misa &= 0x3fffffff;
@@ -40,40 +45,47 @@ namespace machine { namespace CSR {
             write_field_raw(Field::mstatus::UXL, 2);
             write_field_raw(Field::mstatus::SXL, 2);
         }
+        update_interrupt_request();
     }
 
     size_t ControlState::get_register_internal_id(Address address) {
         // if (address.get_privilege_level() != PrivilegeLevel::MACHINE)
 
-        try {
-            return CSR::REGISTER_MAP.at(address);
-        } catch (std::out_of_range &e) {
+        size_t reg_id = CSR::REGISTER_MAP.find(address);
+        if (reg_id == RegisterMap::INVALID) {
             throw SIMULATOR_EXCEPTION(
                 UnsupportedInstruction,
                 QString("Accessed nonexistent CSR register %1").arg(address.data), "");
         }
+        return reg_id;
     }
 
     RegisterValue ControlState::read(Address address) const {
+        return read_by_id(get_register_internal_id(address));
+    }
+
+    RegisterValue ControlState::read_by_id(size_t internal_id) const {
         // Only machine level privilege is supported so no checking is needed.
-        size_t reg_id = get_register_internal_id(address);
-        RegisterValue value = register_data[reg_id];
-        DEBUG("Read CSR[%u] == 0x%" PRIx64, address.data, value.as_u64());
-        emit read_signal(reg_id, value);
+        RegisterValue value = read_internal(internal_id);
+        DEBUG("Read CSR[%u] == 0x%" PRIx64, REGISTERS[internal_id].address.data, value.as_u64());
+        emit read_signal(internal_id, value);
         return value;
     }
 
     void ControlState::write(Address address, RegisterValue value) {
-        DEBUG(
-            "Write CSR[%u/%zu] <== 0x%zu", address.data, get_register_internal_id(address),
-            value.as_u64());
+        write_by_id(get_register_internal_id(address), value);
+    }
+
+    void ControlState::write_by_id(size_t internal_id, RegisterValue value) {
+        const Address address = REGISTERS[internal_id].address;
+        DEBUG("Write CSR[%u/%zu] <== 0x%zu", address.data, internal_id, value.as_u64());
         // Attempts to write a read-only register also raise illegal instruction exceptions.
         if (!address.is_writable()) {
             throw SIMULATOR_EXCEPTION(
                 UnsupportedInstruction,
                 QString("CSR address %1 is not writable.").arg(address.data), "");
         }
-        write_internal(get_register_internal_id(address), value);
+        write_internal(internal_id, value);
     }
 
     void ControlState::default_wlrl_write_handler(
@@ -105,7 +117,11 @@ namespace machine { namespace CSR {
     }
 
     bool ControlState::operator==(const ControlState &other) const {
-        return register_data == other.register_data;
+        // Counter entries of register_data are not kept up to date.
+        for (size_t i = 0; i < Id::_COUNT; i++) {
+            if (read_internal(i) != other.read_internal(i)) { return false; }
+        }
+        return true;
     }
 
     bool ControlState::operator!=(const ControlState &c) const {
@@ -144,16 +160,19 @@ namespace machine { namespace CSR {
         } else {
             value = value.as_xlen(xlen) & ~mask;
         }
+        update_interrupt_request();
         emit write_signal(reg_id, value);
     }
 
-    bool ControlState::core_interrupt_request() {
+    void ControlState::update_interrupt_request() {
+        interrupt_request = core_interrupt_pending() && read_field(Field::mstatus::MIE).as_u64();
+    }
+
+    bool ControlState::core_interrupt_pending() const {
         RegisterValue mie = register_data[Id::MIE];
         RegisterValue mip = register_data[Id::MIP];
 
-        uint64_t irqs = mie.as_u64() & mip.as_u64() & 0xffffffff;
-
-        return irqs && read_field(Field::mstatus::MIE).as_u64();
+        return (mie.as_u64() & mip.as_u64() & 0xffffffff) != 0;
     }
 
     void ControlState::exception_initiate(PrivilegeLevel act_privlev, PrivilegeLevel to_privlev) {
@@ -192,17 +211,30 @@ namespace machine { namespace CSR {
     }
 
     RegisterValue ControlState::read_internal(size_t internal_id) const {
-        return register_data[internal_id];
+        switch (internal_id) {
+        case Id::CYCLE:
+        case Id::MCYCLE: return cycle_count;
+        case Id::MINSTRET: return instret_count;
+        default: return register_data[internal_id];
+        }
     }
 
     void ControlState::write_internal(size_t internal_id, RegisterValue value) {
         RegisterDesc desc = REGISTERS[internal_id];
         RegisterValue &reg = register_data[internal_id];
         (this->*desc.write_handler)(desc, reg, value);
+        switch (internal_id) {
+        case Id::MSTATUS:
+        case Id::MIE:
+        case Id::MIP: update_interrupt_request(); break;
+        case Id::MCYCLE: cycle_count = reg.as_u64(); break;
+        case Id::MINSTRET: instret_count = reg.as_u64(); break;
+        default: break;
+        }
         write_signal(internal_id, reg);
     }
     void ControlState::increment_internal(size_t internal_id, uint64_t amount) {
-        auto value = register_data[internal_id];
+        auto value = read_internal(internal_id);
         write_internal(internal_id, value.as_u64() + amount);
     }
 }} // namespace machine::CSR
@@ -11,8 +11,9 @@
 
 #include <QObject>
 #include <QString>
+#include <array>
 #include <cstdint>
-#include <unordered_map>
+#include <stdexcept>
 
 namespace machine { namespace CSR {
     /** CSR register names mapping the registers to continuous locations in internal buffer */
@@ -88,6 +89,12 @@ namespace machine { namespace CSR {
         /** Read CSR register with ISA specified address. */
         [[nodiscard]] RegisterValue read(Address address) const;
 
+        /**
+         * Same as `read`, but with internal id already resolved by `get_register_internal_id`
+         * (e.g. at instruction decode).
+         */
+        [[nodiscard]] RegisterValue read_by_id(size_t internal_id) const;
+
         /**
          * Read CSR register with an internal id.
          *
@@ -99,6 +106,16 @@ namespace machine { namespace CSR {
         /** Write value to CSR register by ISA specified address and receive the previous value. */
         void write(Address address, RegisterValue value);
 
+        /** Same as `write`, but with internal id already resolved. */
+        void write_by_id(size_t internal_id, RegisterValue value);
+
+        /**
+         * Translate CSR address to internal id.
+         *
+         * @throws SimulatorExceptionUnsupportedInstruction if there is no such register
+         */
+        static size_t get_register_internal_id(Address address);
+
         /** Used for writes occurring as a side-effect (instruction count update...) and
          * internally by the write method. */
         void write_internal(size_t internal_id, RegisterValue value);
@@ -107,6 +124,15 @@ namespace machine { namespace CSR {
          * amount. */
         void increment_internal(size_t internal_id, uint64_t amount);
 
+        /**
+         * Count one cycle (MCYCLE/CYCLE) or retired instruction (MINSTRET).
+         *
+         * These are called by the core every cycle, so they only update plain integers and no
+         * signal is emitted. The value is materialized when the register is read or written.
+         */
+        void increment_cycle() { cycle_count++; }
+        void increment_instret() { instret_count++; }
+
         /** Reset data to initial values */
         void reset();
 
@@ -127,7 +153,13 @@ namespace machine { namespace CSR {
         bool operator==(const ControlState &other) const;
         bool operator!=(const ControlState &c) const;
 
-        bool core_interrupt_request();
+        /**
+         * Some interrupt is pending, enabled and globally enabled. The state is cached and updated
+         * only when MIP, MIE or MSTATUS changes, so this is cheap to check every cycle.
+         */
+        bool core_interrupt_request() const { return interrupt_request; }
+        /** Some enabled interrupt is pending, regardless of global enable (WFI wake-up). */
+        bool core_interrupt_pending() const;
         machine::Address exception_pc_address();
 
     signals:
@@ -140,7 +172,8 @@ namespace machine { namespace CSR {
         PrivilegeLevel exception_return(enum PrivilegeLevel act_privlev);
 
     private:
-        static size_t get_register_internal_id(Address address);
+        /** Recompute cached interrupt request after a change of MIP, MIE or MSTATUS. */
+        void update_interrupt_request();
 
         /** Write CSR register field without write handler, read-only masking and signal */
         void write_field_raw(const RegisterFieldDesc &field_desc, uint64_t value) {
@@ -157,6 +190,13 @@ namespace machine { namespace CSR {
          */
         std::array<RegisterValue, Id::_COUNT> register_data;
 
+        /** @copydoc core_interrupt_request */
+        bool interrupt_request = false;
+
+        /** Values of MCYCLE (shadowed by CYCLE) and MINSTRET, see `increment_cycle`. */
+        uint64_t cycle_count = 0;
+        uint64_t instret_count = 0;
+
     public:
         void default_wlrl_write_handler(
             const RegisterDesc &desc,
@@ -233,27 +273,40 @@ namespace machine { namespace CSR {
         [Id::MINSTRET] = { "minstret", 0xB02_csr, "Machine instructions-retired counter."},
     } };
 
-    /** Lookup from CSR address (value used in instruction) to internal id (index in continuous
-     * memory) */
+    /**
+     * Lookup from CSR address (value used in instruction) to internal id (index in continuous
+     * memory). Direct table over the whole 12-bit address space generated at compile time.
+     */
     class RegisterMap {
-        bool initialized = false;
-        std::unordered_map<Address, size_t> map;
+    public:
+        /** Marks address without existing register. */
+        static constexpr uint8_t INVALID = 0xff;
+        static_assert(Id::_COUNT < INVALID, "Internal id has to fit into the table");
 
-        void init() {
+        constexpr RegisterMap() {
+            for (auto &id : ids) {
+                id = INVALID;
+            }
             for (size_t i = 0; i < REGISTERS.size(); i++) {
-                map.emplace(REGISTERS[i].address, i);
+                ids[REGISTERS[i].address.data] = static_cast<uint8_t>(i);
             }
-            initialized = true;
         }
 
-    public:
-        size_t at(Address address) {
-            if (!initialized) init();
-            return map.at(address);
+        /** Internal id of register at given address or INVALID. */
+        [[nodiscard]] constexpr size_t find(Address address) const { return ids[address.data]; }
+
+        /** @throws std::out_of_range if there is no register at given address */
+        [[nodiscard]] size_t at(Address address) const {
+            size_t id = find(address);
+            if (id == INVALID) { throw std::out_of_range("Nonexistent CSR register"); }
+            return id;
         }
+
+    private:
+        std::array<uint8_t, 1U << 12> ids {};
     };
 
-    static RegisterMap REGISTER_MAP;
+    inline constexpr RegisterMap REGISTER_MAP {};
 }} // namespace machine::CSR
 
 Q_DECLARE_METATYPE(machine::CSR::ControlState)
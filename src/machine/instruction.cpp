@@ -8,13 +8,16 @@
 #include "utils.h"
 
 #include <QChar>
-#include <QMultiMap>
+#include <QMap>
+#include <algorithm>
+#include <array>
 #include <cctype>
 #include <cinttypes>
 #include <cstring>
 #include <set>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 LOG_CATEGORY("machine.instruction");
 
@@ -453,6 +456,18 @@ static const struct InstructionMap ENVIRONMENT_AND_BREAKPOINTS_map[] = {
     {"ebreak", IT_I, NOALU, NOMEM, nullptr, {}, 0x00100073, 0xffffffff, { .flags = IMF_SUPPORTED | IMF_EXCEPTION | IMF_EBREAK }, nullptr},
 };
 
+// Priviledged instructions sharing funct7 0b0001000, distinguished by rs2 field (22:20)
+static const struct InstructionMap SYSTEM_PRIV_SRET_WFI_map[] = {
+    IM_UNKNOWN,
+    IM_UNKNOWN,
+    {"sret", IT_I, NOALU, NOMEM, nullptr, {}, 0x10200073, 0xffffffff, { .flags = IMF_SUPPORTED | IMF_XRET }, nullptr},
+    IM_UNKNOWN,
+    IM_UNKNOWN,
+    {"wfi", IT_I, NOALU, NOMEM, nullptr, {}, 0x10500073, 0xffffffff, { .flags = IMF_SUPPORTED | IMF_WFI }, nullptr},
+    IM_UNKNOWN,
+    IM_UNKNOWN,
+};
+
 // Priviledged system isntructions, only 5-bits (29:25) are decoded for now.
 // Full decode is should cover 128 entries (31:25) but we radly support hypervisor even in future
 static const struct InstructionMap SYSTEM_PRIV_map[] = {
@@ -464,7 +479,7 @@ static const struct InstructionMap SYSTEM_PRIV_map[] = {
     IM_UNKNOWN,
     IM_UNKNOWN,
     IM_UNKNOWN,
-    {"sret", IT_I, NOALU, NOMEM, nullptr, {}, 0x10200073, 0xffffffff, { .flags = IMF_SUPPORTED | IMF_XRET }, nullptr},
+    {"sret/wfi", IT_I, NOALU, NOMEM, SYSTEM_PRIV_SRET_WFI_map, {}, 0x10000073, 0xfe0fffff, { .subfield = {3, 20} }, nullptr},
     IM_UNKNOWN,
     IM_UNKNOWN,
     IM_UNKNOWN,
@@ -629,15 +644,124 @@ static const struct InstructionMap C_inst_unknown = IM_UNKNOWN;
 
 const BitField instruction_map_opcode_field = { 2, 0 };
 
-static inline const struct InstructionMap &InstructionMapFind(uint32_t code) {
+/** Walks the decode tree down to a leaf. Leaf mask is not checked. */
+static const struct InstructionMap *InstructionMapFindLeaf(uint32_t code) {
     const struct InstructionMap *im = &C_inst_map[instruction_map_opcode_field.decode(code)];
     while (im->subclass != nullptr) {
         im = &im->subclass[im->subfield.decode(code)];
     }
+    return im;
+}
+
+/** Bits of the first level index of the decode table: opcode (6:0) and funct3 (14:12). */
+static constexpr uint32_t DECODE_TABLE_FIRST_MASK = 0x0000707f;
+
+/**
+ * Collects bits decoded by the subtree of `im` for codes matching `base` in the first level bits.
+ *
+ * Subfields within the first level bits select a single child, others are followed to all children.
+ */
+static uint32_t InstructionMapDecodedBits(const struct InstructionMap *im, uint32_t base) {
+    if (im->subclass == nullptr) { return 0; }
+    const auto field_mask = static_cast<uint32_t>(im->subfield.mask());
+    if ((field_mask & ~DECODE_TABLE_FIRST_MASK) == 0) {
+        const struct InstructionMap *child = &im->subclass[im->subfield.decode(base)];
+        return field_mask | InstructionMapDecodedBits(child, base);
+    }
+    uint32_t bits = field_mask;
+    for (uint32_t i = 0; i < (1U << im->subfield.count); i++) {
+        if ((im->subfield.encode(i) ^ base) & field_mask & DECODE_TABLE_FIRST_MASK) { continue; }
+        bits |= InstructionMapDecodedBits(&im->subclass[i], base);
+    }
+    return bits;
+}
+
+/**
+ * Decode tree flattened into a two level table.
+ *
+ * The first level is indexed by opcode (bits 6:0) and funct3 (bits 14:12). When the subtree
+ * decodes also upper bits, the entry refers to a second level indexed by funct7 (bits 31:25), or by
+ * funct7 and rs2 (bits 31:20) where needed (SYSTEM). No tree level decodes rd or rs1 fields, which
+ * is verified against the tree by `Instruction::decode_table_matches_tree`.
+ *
+ * The maps hold QStrings, therefore the table is built during static initialization and not at
+ * compile time. Decoded bits are taken from the tree structure, so only the few entries with
+ * a second level walk the tree per code.
+ */
+class InstructionDecodeTable {
+public:
+    InstructionDecodeTable();
+
+    /** Leaf for given code. Leaf mask has to be checked by the caller. */
+    const InstructionMap *find(uint32_t code) const {
+        const Entry &entry = first[(code & 0x7f) | ((code >> 5) & 0x380)];
+        if (entry.leaf != nullptr) { return entry.leaf; }
+        return second[entry.second_base + entry.second_field.decode(code)];
+    }
+
+private:
+    struct Entry {
+        const InstructionMap *leaf = nullptr;
+        BitField second_field = { 0, 0 };
+        uint32_t second_base = 0;
+    };
+
+    std::array<Entry, 1U << 10> first;
+    std::vector<const InstructionMap *> second;
+};
+
+InstructionDecodeTable::InstructionDecodeTable() {
+    for (uint32_t i = 0; i < first.size(); i++) {
+        const uint32_t base = (i & 0x7f) | ((i & 0x380) << 5);
+        const struct InstructionMap *root = &C_inst_map[instruction_map_opcode_field.decode(base)];
+        const uint32_t upper_bits = InstructionMapDecodedBits(root, base)
+                                    & ~DECODE_TABLE_FIRST_MASK;
+        if (upper_bits == 0) {
+            first[i].leaf = InstructionMapFindLeaf(base);
+            continue;
+        }
+        // Funct7 alone where possible, funct7 and rs2 otherwise.
+        first[i].second_field = (upper_bits & ~0xfe000000U) ? BitField { 12, 20 }
+                                                            : BitField { 7, 25 };
+        first[i].second_base = static_cast<uint32_t>(second.size());
+        for (uint32_t j = 0; j < (1U << first[i].second_field.count); j++) {
+            second.push_back(InstructionMapFindLeaf(base | first[i].second_field.encode(j)));
+        }
+    }
+}
+
+// Has to be defined after the maps to be initialized after them.
+static const InstructionDecodeTable instruction_decode_table;
+
+static inline const struct InstructionMap &InstructionMapFind(uint32_t code) {
+    const struct InstructionMap *im = instruction_decode_table.find(code);
+    if ((code ^ im->code) & im->mask) { return C_inst_unknown; }
+    return *im;
+}
+
+/** Reference decode, walking the tree at each level. */
+static inline const struct InstructionMap &InstructionMapFindTree(uint32_t code) {
+    const struct InstructionMap *im = InstructionMapFindLeaf(code);
     if ((code ^ im->code) & im->mask) { return C_inst_unknown; }
     return *im;
 }
 
+bool Instruction::decode_table_matches_tree() {
+    // Rd and rs1 are not decoded by the table, both are tested zero (as some SYSTEM instructions
+    // require) and all ones.
+    for (uint32_t regs : { 0x00000000U, 0x000f8f80U }) {
+        for (uint32_t index = 0; index < (1U << 22); index++) {
+            const uint32_t code = (index & 0x7f) | ((index & 0x380) << 5) | ((index >> 10) << 20)
+                                  | regs;
+            if (&InstructionMapFind(code) != &InstructionMapFindTree(code)) {
+                ERROR("decode table mismatch for 0x%08" PRIx32, code);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 const std::array<const QString, 36> RECOGNIZED_PSEUDOINSTRUCTIONS { "nop",    "la",     "li",
                                                                     "sext.b", "sext.h", "zext.h",
                                                                     "zext.w", "call",   "tail" };
@@ -764,25 +888,105 @@ Instruction &Instruction::operator=(const Instruction &c) {
     return *this;
 }
 
-QString Instruction::to_str(Address inst_addr) const {
+namespace {
+
+/**
+ * Writes text into a fixed size buffer without any allocation. Output exceeding the buffer is
+ * dropped, but still counted, so the caller can detect truncation (like `snprintf`).
+ */
+class TextSink {
+public:
+    TextSink(char *buffer, size_t size) : buffer(buffer), size(size) {}
+
+    void put(char ch) {
+        if (length + 1 < size) { buffer[length] = ch; }
+        length++;
+    }
+    void put(const char *str) {
+        while (*str != '\0') {
+            put(*str++);
+        }
+    }
+    void put_hex(uint32_t value) {
+        char digits[8];
+        int count = 0;
+        do {
+            digits[count++] = "0123456789abcdef"[value & 0xf];
+            value >>= 4;
+        } while (value != 0);
+        put("0x");
+        while (count > 0) {
+            put(digits[--count]);
+        }
+    }
+    /** Same format as `str::asHex` of a signed value. */
+    void put_hex(int32_t value) {
+        if (value < 0) {
+            put('-');
+            put_hex(-uint32_t(value));
+        } else {
+            put_hex(uint32_t(value));
+        }
+    }
+    void put_dec(int32_t value) {
+        char digits[10];
+        int count = 0;
+        uint32_t magnitude = value < 0 ? -uint32_t(value) : uint32_t(value);
+        do {
+            digits[count++] = char('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (value < 0) { put('-'); }
+        while (count > 0) {
+            put(digits[--count]);
+        }
+    }
+    /** Terminates the text, @return length of the complete (not truncated) text. */
+    size_t finish() {
+        if (size > 0) { buffer[std::min(length, size - 1)] = '\0'; }
+        return length;
+    }
+
+private:
+    char *const buffer;
+    const size_t size;
+    size_t length = 0;
+};
+
+} // namespace
+
+size_t Instruction::to_str(char *buffer, size_t size, Address inst_addr) const {
+    bool address_used;
+    return format(buffer, size, inst_addr, address_used);
+}
+
+size_t
+Instruction::format(char *buffer, size_t size, Address inst_addr, bool &address_used) const {
     const InstructionMap &im = InstructionMapFind(dt);
     // TODO there are exception where some fields are zero and such so we should
     // not print them in such case
     SANITY_ASSERT(argdesbycode_filled, QString("argdesbycode_filled not initialized"));
-    QString res;
-    QString next_delim = " ";
-    if (im.type == UNKNOWN) { return { "unknown" }; }
-    if (this->dt == NOP.dt) { return { "nop" }; }
+    TextSink res(buffer, size);
+    const char *next_delim = " ";
+    address_used = false;
+    if (im.type == UNKNOWN) {
+        res.put("unknown");
+        return res.finish();
+    }
+    if (this->dt == NOP.dt) {
+        res.put("nop");
+        return res.finish();
+    }
 
-    res += im.name;
+    res.put(im.name);
     for (const QString &arg_string : im.args) {
-        res += next_delim;
+        res.put(next_delim);
         next_delim = ", ";
         for (int pos = 0; pos < arg_string.size(); pos += 1) {
             char arg_letter = arg_string[pos].toLatin1();
             const ArgumentDesc *arg_desc = arg_desc_by_code[(unsigned char)arg_letter];
             if (arg_desc == nullptr) {
-                res += arg_letter;
+                res.put(arg_letter);
                 continue;
             }
             auto field = (int32_t)arg_desc->arg.decode(this->dt);
@@ -798,46 +1002,130 @@ QString Instruction::to_str(Address inst_addr) const {
             switch (arg_desc->kind) {
             case 'g': {
                 if (symbolic_registers_enabled) {
-                    res += QString(Rv_regnames[field]);
+                    res.put(Rv_regnames[field]);
                 } else {
-                    res += "x" + QString::number(field);
+                    res.put('x');
+                    res.put_dec(field);
                 }
                 break;
             }
             case 'p':
             case 'a': {
                 field += (int32_t)inst_addr.get_raw();
-                res.append(str::asHex(uint32_t(field)));
+                address_used = true;
+                res.put_hex(uint32_t(field));
                 break;
             }
             case 'o':
             case 'n': {
                 if (arg_desc->min < 0) {
-                    res += QString::number((int32_t)field, 10);
+                    res.put_dec(field);
                 } else {
-                    res.append(str::asHex(uint32_t(field)));
+                    res.put_hex(uint32_t(field));
                 }
                 break;
             }
             case 'E': {
+                size_t csr_id = CSR::RegisterMap::INVALID;
                 if (symbolic_registers_enabled) {
-                    try {
-                        res += CSR::REGISTERS[CSR::REGISTER_MAP.at(CSR::Address(field))].name;
-                    } catch (std::out_of_range &e) { res.append(str::asHex(field)); }
+                    csr_id = CSR::REGISTER_MAP.find(CSR::Address(field));
+                }
+                if (csr_id != CSR::RegisterMap::INVALID) {
+                    res.put(CSR::REGISTERS[csr_id].name);
                 } else {
-                    res.append(str::asHex(field));
+                    res.put_hex(field);
                 }
                 break;
             }
             }
         }
     }
-    return res;
+    return res.finish();
+}
+
+QString Instruction::to_str(Address inst_addr) const {
+    /**
+     * Direct mapped cache of formatted instructions. The text depends on the encoding, register
+     * naming mode and, for PC relative instructions only, on the address of the instruction.
+     */
+    struct CacheEntry {
+        bool valid = false;
+        bool symbolic = false;
+        bool address_used = false;
+        uint32_t dt = 0;
+        uint64_t address = 0;
+        QString text;
+    };
+    constexpr unsigned CACHE_BITS = 10;
+    static thread_local std::array<CacheEntry, 1U << CACHE_BITS> cache;
+
+    CacheEntry &entry = cache[(dt * 2654435761U) >> (32 - CACHE_BITS)];
+    if (entry.valid && entry.dt == dt && entry.symbolic == symbolic_registers_enabled
+        && (!entry.address_used || entry.address == inst_addr.get_raw())) {
+        return entry.text;
+    }
+    char buffer[MAX_STR_SIZE];
+    size_t length = format(buffer, sizeof(buffer), inst_addr, entry.address_used);
+    entry.valid = true;
+    entry.symbolic = symbolic_registers_enabled;
+    entry.dt = dt;
+    entry.address = inst_addr.get_raw();
+    entry.text = QString::fromLatin1(buffer, int(std::min(length, sizeof(buffer) - 1)));
+    return entry.text;
 }
 
-QMultiMap<QString, uint32_t> str_to_instruction_code_map;
+/**
+ * Mnemonic lookup for the assembler.
+ *
+ * Maps a lower case mnemonic to the codes of all instructions (base instructions and aliases) it
+ * may denote. The table is a perfect hash: its size and seed are searched at runtime, when the
+ * table is first used (see `mnemonic_table`), so that each mnemonic has a slot of its own. A lookup
+ * costs one hash and one string compare.
+ */
+class MnemonicTable {
+public:
+    MnemonicTable();
+
+    /** Candidate codes in the order they are to be tried, nullptr for unknown mnemonic. */
+    const std::vector<uint32_t> *find(const QString &name) const {
+        const int16_t index = slots[mnemonic_hash(name, seed) & slot_mask];
+        if (index < 0 || names[index] != name) { return nullptr; }
+        return &codes[index];
+    }
+
+    /** All known mnemonics in alphabetical order. */
+    const QStringList &all_names() const { return names; }
+
+private:
+    QStringList names;
+    std::vector<std::vector<uint32_t>> codes;
+    std::vector<int16_t> slots;
+    uint32_t slot_mask = 0;
+    uint32_t seed = 0;
+
+    static uint32_t mnemonic_hash(const QString &name, uint32_t seed) {
+        // FNV-1a
+        uint32_t hash = 2166136261U ^ seed;
+        for (QChar ch : name) {
+            hash ^= ch.unicode();
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+
+    void add(const char *name, uint32_t code);
+    void add_aliases(uint32_t base_code, uint32_t base_mask, const InstructionMap *ia);
+    void add_subtree(const InstructionMap *im, BitField field, uint32_t base_code, uint32_t base_mask);
+
+    /** Codes are collected per name here before the hash table is built. */
+    QMap<QString, std::vector<uint32_t>> collected;
+};
 
-static void instruction_from_string_build_base_aliases(
+void MnemonicTable::add(const char *name, uint32_t code) {
+    collected[QString::fromLatin1(name)].push_back(code);
+}
+
+void MnemonicTable::add_aliases(
     uint32_t base_code,
     uint32_t base_mask,
     const InstructionMap *ia) {
@@ -856,22 +1144,15 @@ static void instruction_from_string_build_base_aliases(
                 ia->name, base_code, base_mask, ia->code, ia->mask);
             continue;
         }
-        bool found = false;
-        auto iter_range = str_to_instruction_code_map.equal_range(ia->name);
-        for (auto i = iter_range.first; i != iter_range.second; i += 1) {
-            if (i.value() == base_code) {
-                found = true;
-                break;
-            }
-        }
-        if (found) continue;
+        const std::vector<uint32_t> &known = collected[QString::fromLatin1(ia->name)];
+        if (std::find(known.begin(), known.end(), base_code) != known.end()) { continue; }
 
         // store base code, the iteration over alliases is required anyway
-        str_to_instruction_code_map.insert(ia->name, base_code);
+        add(ia->name, base_code);
     }
 }
 
-void instruction_from_string_build_base(
+void MnemonicTable::add_subtree(
     const InstructionMap *im,
     BitField field,
     uint32_t base_code,
@@ -885,7 +1166,7 @@ void instruction_from_string_build_base(
     for (unsigned int i = 0; i < 1U << bits; i++, im++) {
         code = base_code | (i << shift);
         if (im->subclass) {
-            instruction_from_string_build_base(im->subclass, im->subfield, code, base_mask);
+            add_subtree(im->subclass, im->subfield, code, base_mask);
             continue;
         }
         if (!(im->flags & IMF_SUPPORTED)) { continue; }
@@ -903,20 +1184,46 @@ void instruction_from_string_build_base(
                 im->name, code, base_mask, im->code, im->mask);
             continue;
         }
-        str_to_instruction_code_map.insert(im->name, im->code);
+        add(im->name, im->code);
+
+        if (im->aliases != nullptr) add_aliases(im->code, im->mask, im->aliases);
+    }
+}
+
+MnemonicTable::MnemonicTable() {
+    add_subtree(C_inst_map, instruction_map_opcode_field, 0, 0);
+
+    for (auto it = collected.begin(); it != collected.end(); it++) {
+        names.append(it.key());
+        // Later registered codes take precedence (as with the former QMultiMap).
+        codes.emplace_back(it.value().rbegin(), it.value().rend());
+    }
+    collected.clear();
 
-        if (im->aliases != nullptr)
-            instruction_from_string_build_base_aliases(im->code, im->mask, im->aliases);
+    // Find a seed without collisions, growing the table when it gets too crowded.
+    uint32_t size = 1;
+    while (size < 2 * uint32_t(names.size())) {
+        size *= 2;
+    }
+    for (; slots.empty(); size *= 2) {
+        slot_mask = size - 1;
+        for (seed = 0; seed < 1000; seed++) {
+            slots.assign(slot_mask + 1, -1);
+            bool collision = false;
+            for (int i = 0; i < names.size() && !collision; i++) {
+                int16_t &slot = slots[mnemonic_hash(names[i], seed) & slot_mask];
+                collision = slot >= 0;
+                slot = static_cast<int16_t>(i);
+            }
+            if (!collision) { break; }
+            slots.clear();
+        }
     }
-#if 0
-    for (auto i = str_to_instruction_code_map.begin();
-         i != str_to_instruction_code_map.end(); i++)
-        std::cout << i.key().toStdString() << ' ';
-#endif
 }
 
-void instruction_from_string_build_base() {
-    return instruction_from_string_build_base(C_inst_map, instruction_map_opcode_field, 0, 0);
+static const MnemonicTable &mnemonic_table() {
+    static const MnemonicTable table;
+    return table;
 }
 
 static int parse_reg_from_string(const QString &str, uint *chars_taken = nullptr) {
@@ -1014,8 +1321,6 @@ size_t Instruction::code_from_tokens(
     TokenizedInstruction &inst,
     RelocExpressionList *reloc,
     bool pseudoinst_enabled) {
-    if (str_to_instruction_code_map.isEmpty()) { instruction_from_string_build_base(); }
-
     Instruction result = base_from_tokens(inst, reloc);
     if (result.data() != 0) {
         if (result.size() > buffsize) {
@@ -1192,50 +1497,54 @@ Instruction Instruction::base_from_tokens(
     RelocExpressionList *reloc,
     Modifier pseudo_mod,
     uint64_t initial_immediate_value) {
-    int rethrow = false;
-    ParseError parse_error = ParseError("no match for arguments combination found");
-    auto iter_range = str_to_instruction_code_map.equal_range(inst.base);
-    if (iter_range.first == iter_range.second) {
+    bool failed = false;
+    QString parse_error = "no match for arguments combination found";
+    const std::vector<uint32_t> *candidates = mnemonic_table().find(inst.base);
+    if (candidates == nullptr) {
         DEBUG("Base instruction of the name %s not found.", qPrintable(inst.base));
         return Instruction::UNKNOWN_INST;
     }
     // Process all codes associated with given instruction name and try matching the supplied
-    // instruction field tokens to fields. First matching instruction is used.
-    for (auto it = iter_range.first; it != iter_range.second; it++) {
-        uint32_t inst_code = it.value();
+    // instruction field tokens to fields. First matching instruction is used. Relocations of
+    // an alternative are kept only when the whole alternative matches.
+    RelocExpressionList candidate_reloc;
+    for (uint32_t candidate_code : *candidates) {
         bool processing_aliases = false;
 
-        const InstructionMap *im = &InstructionMapFind(inst_code);
+        const InstructionMap *im = &InstructionMapFind(candidate_code);
         for (; im != nullptr; instruction_code_map_next_im(im, processing_aliases)) {
-            if (inst.base != im->name) continue;
+            if (inst.base != QLatin1String(im->name)) continue;
 
-            try {
-                inst_code = im->code;
-
-                if (inst.fields.count() != (int)im->args.size()) {
-                    if (!rethrow) {
-                        parse_error = ParseError("number of arguments does not match");
-                        rethrow = true;
-                    }
-                    continue;
+            if (inst.fields.count() != (int)im->args.size()) {
+                if (!failed) {
+                    parse_error = "number of arguments does not match";
+                    failed = true;
                 }
+                continue;
+            }
 
-                for (int field_index = 0; field_index < (int)im->args.size(); field_index++) {
-                    const QString &arg = im->args[field_index];
-                    QString field_token = inst.fields[field_index];
-                    inst_code |= parse_field(
-                        field_token, arg, inst.address, reloc, inst.filename, inst.line, pseudo_mod,
-                        initial_immediate_value);
-                }
+            uint32_t inst_code = im->code;
+            bool matched = true;
+            for (int field_index = 0; matched && field_index < (int)im->args.size();
+                 field_index++) {
+                const QString &arg = im->args[field_index];
+                QString field_token = inst.fields[field_index];
+                matched = parse_field(
+                    inst_code, field_token, arg, inst.address,
+                    (reloc != nullptr) ? &candidate_reloc : nullptr, inst.filename, inst.line,
+                    pseudo_mod, initial_immediate_value, parse_error);
+            }
+            if (matched) {
+                if (reloc != nullptr) { reloc->append(candidate_reloc); }
                 return Instruction(inst_code);
-            } catch (ParseError &pe) {
-                rethrow = true;
-                parse_error = pe;
             }
+            failed = true;
+            qDeleteAll(candidate_reloc);
+            candidate_reloc.clear();
         }
     }
 
-    if (rethrow) { throw parse_error; }
+    if (failed) { throw ParseError(parse_error); }
 
     DEBUG(
         "Base instruction of the name %s not matched to any known base format.",
@@ -1258,7 +1567,8 @@ bool parse_immediate_value(
     uint64_t &val,
     uint &chars_taken);
 
-uint32_t Instruction::parse_field(
+bool Instruction::parse_field(
+    uint32_t &inst_code,
     QString &field_token,
     const QString &arg,
     Address inst_addr,
@@ -1266,8 +1576,8 @@ uint32_t Instruction::parse_field(
     const QString &filename,
     unsigned int line,
     Modifier pseudo_mod,
-    uint64_t initial_immediate_value) {
-    uint32_t inst_code = 0;
+    uint64_t initial_immediate_value,
+    QString &error) {
     for (QChar ao : arg) {
         bool need_reloc = false;
         uint a = ao.toLatin1();
@@ -1275,9 +1585,13 @@ uint32_t Instruction::parse_field(
         field_token = field_token.trimmed();
         const ArgumentDesc *adesc = arg_desc_by_code[a];
         if (adesc == nullptr) {
-            if (!field_token.count()) { throw ParseError("empty argument encountered"); }
+            if (!field_token.count()) {
+                error = "empty argument encountered";
+                return false;
+            }
             if (field_token.at(0) != ao) {
-                throw ParseError("argument does not match instruction template");
+                error = "argument does not match instruction template";
+                return false;
             }
             field_token = field_token.mid(1);
             continue;
@@ -1299,26 +1613,33 @@ uint32_t Instruction::parse_field(
             if (!parse_immediate_value(
                     field_token, inst_addr, reloc, filename, line, need_reloc, adesc, effective_mod,
                     val, chars_taken)) {
-                throw ParseError(
-                    QString("field_token %1 is not a valid immediate value").arg(field_token));
+                error = QString("field_token %1 is not a valid immediate value").arg(field_token);
+                return false;
             }
             break;
         }
         case 'E': val = parse_csr_address(field_token, chars_taken); break;
         }
-        if (chars_taken <= 0) { throw ParseError("argument parse error"); }
+        if (chars_taken <= 0) {
+            error = "argument parse error";
+            return false;
+        }
 
         if (effective_mod != Modifier::NONE) {
             val = modify_pseudoinst_imm(effective_mod, val);
         } else if (!adesc->is_value_in_field_range(val)) {
-            throw ParseError("argument range exceed");
+            error = "argument range exceed";
+            return false;
         }
 
         inst_code |= adesc->arg.encode(val);
         field_token = field_token.mid(chars_taken);
     }
-    if (field_token.trimmed() != "") { throw ParseError("excessive characters in argument"); }
-    return inst_code;
+    if (field_token.trimmed() != "") {
+        error = "excessive characters in argument";
+        return false;
+    }
+    return true;
 }
 
 bool parse_immediate_value(
@@ -1434,12 +1755,7 @@ constexpr uint64_t Instruction::modify_pseudoinst_imm(Instruction::Modifier mod,
 
 // highlighter
 void Instruction::append_recognized_instructions(QStringList &list) {
-    if (str_to_instruction_code_map.isEmpty()) { instruction_from_string_build_base(); }
-
-    for (auto iter = str_to_instruction_code_map.keyBegin();
-         iter != str_to_instruction_code_map.keyEnd(); iter++) {
-        list.append(*iter);
-    }
+    list.append(mnemonic_table().all_names());
     for (const auto &str : RECOGNIZED_PSEUDOINSTRUCTIONS) {
         list.append(str);
     }
@@ -60,6 +60,8 @@ enum InstructionFlags : unsigned {
     // TODO do we want to add those signals to the visualization?
 
     IMF_RV64 = 1L << 24, /**< Mark instructions which are available in 64-bit mode only. */
+
+    IMF_WFI = 1L << 25, /**< Wait for interrupt, core may idle until an interrupt is pending */
 };
 
 /**
@@ -163,7 +165,21 @@ public:
     bool operator!=(const Instruction &c) const;
     Instruction &operator=(const Instruction &c);
 
+    /** Buffer size sufficient for any text produced by `to_str`. */
+    static constexpr size_t MAX_STR_SIZE = 64;
+
+    /**
+     * Disassembly of the instruction. Results are cached, so repeated formatting of the same
+     * instruction (e.g. on each repaint of the program view) is cheap.
+     */
     QString to_str(Address inst_addr = Address::null()) const;
+    /**
+     * Disassembly written into a caller provided buffer without any heap allocation.
+     * The text is always NUL terminated and truncated when it does not fit.
+     *
+     * @return length of the complete text (excluding the terminating NUL)
+     */
+    size_t to_str(char *buffer, size_t size, Address inst_addr = Address::null()) const;
 
     /**
      * Parses instruction from string containing one assembler line.
@@ -199,6 +215,12 @@ public:
     static void append_recognized_registers(QStringList &list);
     static constexpr uint64_t modify_pseudoinst_imm(Modifier mod, uint64_t value);
 
+    /**
+     * Checks that the flattened decode table decodes every combination of opcode, funct3, funct7
+     * and rs2 fields to the same instruction as the decode tree. Intended for tests.
+     */
+    static bool decode_table_matches_tree();
+
 private:
     uint32_t dt;
     static bool symbolic_registers_enabled;
@@ -209,7 +231,16 @@ private:
         Modifier pseudo_mod = Modifier::NONE,
         uint64_t initial_immediate_value = 0);
     inline int32_t extend(uint32_t value, uint32_t used_bits) const;
-    static uint32_t parse_field(
+    /** @param address_used set when the text depends on `inst_addr` (PC relative argument) */
+    size_t format(char *buffer, size_t size, Address inst_addr, bool &address_used) const;
+    /**
+     * Parses a single field token into `inst_code`.
+     *
+     * Does not throw, so that a mismatch of one alternative of an instruction is cheap.
+     * @return false and sets `error` when the token does not match the template
+     */
+    static bool parse_field(
+        uint32_t &inst_code,
         QString &field_token,
         const QString &arg,
         Address inst_addr,
@@ -217,7 +248,8 @@ private:
         const QString &filename,
         unsigned int line,
         Modifier pseudo_mod,
-        uint64_t initial_immediate_value);
+        uint64_t initial_immediate_value,
+        QString &error);
     static size_t partially_apply(
         const char *base,
         int argument_count,
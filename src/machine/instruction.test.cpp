@@ -27,6 +27,43 @@ void TestInstruction::instruction_access() {
     QCOMPARE(i.address().get_raw(), (uint64_t)0x3ffffff);
 }
 
-// TODO test to_str
+// Test that flattened decode table matches decode tree for every decoded field combination
+void TestInstruction::instruction_decode_table() {
+    QVERIFY(Instruction::decode_table_matches_tree());
+}
+
+// Test disassembly through both the cached and the buffer variant of to_str
+void TestInstruction::instruction_to_str() {
+    QCOMPARE(Instruction(0x00000013).to_str(), QString("nop"));
+    QCOMPARE(Instruction(0x00a00513).to_str(), QString("addi x10, x0, 10"));
+    QCOMPARE(Instruction(0xfff00513).to_str(), QString("addi x10, x0, -1"));
+    // PC relative argument, the cached text must follow the address.
+    QCOMPARE(Instruction(0x00000463).to_str(0x200_addr), QString("beq x0, x0, 0x208"));
+    QCOMPARE(Instruction(0x00000463).to_str(0x300_addr), QString("beq x0, x0, 0x308"));
+
+    Instruction::set_symbolic_registers(true);
+    QCOMPARE(Instruction(0x00a00513).to_str(), QString("addi a0, zero, 10"));
+    Instruction::set_symbolic_registers(false);
+    QCOMPARE(Instruction(0x00a00513).to_str(), QString("addi x10, x0, 10"));
+
+    char buffer[Instruction::MAX_STR_SIZE];
+    QCOMPARE(Instruction(0x00a00513).to_str(buffer, sizeof(buffer)), size_t(16));
+    QCOMPARE(QString(buffer), QString("addi x10, x0, 10"));
+    // Truncated output is still terminated and reports the full length.
+    QCOMPARE(Instruction(0x00a00513).to_str(buffer, 5), size_t(16));
+    QCOMPARE(QString(buffer), QString("addi"));
+}
+
+// Disassembly throughput of the allocation free variant over a range of encodings
+void TestInstruction::instruction_to_str_benchmark() {
+    char buffer[Instruction::MAX_STR_SIZE];
+    size_t total = 0;
+    QBENCHMARK {
+        for (uint32_t code = 0x00000013; code < 0x00100013; code += 0x1000) {
+            total += Instruction(code | 0x500).to_str(buffer, sizeof(buffer), 0x200_addr);
+        }
+    }
+    QVERIFY(total > 0);
+}
 
 QTEST_APPLESS_MAIN(TestInstruction)
@@ -9,6 +9,11 @@ class TestInstruction : public QObject {
 public slots:
     void instruction();
     void instruction_access();
+
+private slots:
+    void instruction_decode_table();
+    void instruction_to_str();
+    void instruction_to_str_benchmark();
 };
 
 #endif // INSTRUCTION_TEST_H
@@ -2,6 +2,7 @@
 
 #include "programloader.h"
 
+#include <QSignalBlocker>
 #include <QTime>
 #include <utility>
 
@@ -13,23 +14,22 @@ Machine::Machine(MachineConfig config, bool load_symtab, bool load_executable)
     regs = new Registers();
 
     if (load_executable) {
-        ProgramLoader program(machine_config.elf());
-        this->machine_config.set_simulated_endian(program.get_endian());
-        mem_program_only = new Memory(machine_config.get_simulated_endian());
-        program.to_memory(mem_program_only);
+        auto program = ProgramLoader::load_cached(machine_config.elf());
+        this->machine_config.set_simulated_endian(program->endian);
+        mem_program_only = new Memory(program->memory);
 
-        if (program.get_architecture_type() == ARCH64)
+        if (program->architecture_type == ARCH64)
             this->machine_config.set_simulated_xlen(Xlen::_64);
         else
             this->machine_config.set_simulated_xlen(Xlen::_32);
 
         if (load_symtab) {
-            symtab = program.get_symbol_table();
+            symtab = program->create_symbol_table();
         }
 
-        program_end = program.end();
-        if (program.get_executable_entry() != 0x0_addr) {
-            regs->write_pc(program.get_executable_entry());
+        program_end = program->end;
+        if (program->executable_entry != 0x0_addr) {
+            regs->write_pc(program->executable_entry);
         }
         mem = new Memory(*mem_program_only);
     } else {
@@ -88,6 +88,7 @@ Machine::Machine(MachineConfig config, bool load_symtab, bool load_executable)
         cr = new CoreSingle(regs, predictor, cch_program, cch_data, controlst,
                             machine_config.get_simulated_xlen(), machine_config.get_isa_word());
     }
+    cr->set_idle_detection(machine_config.idle_fast_forward());
     connect(
         this, &Machine::set_interrupt_signal, controlst, &CSR::ControlState::set_interrupt_signal);
 
@@ -334,13 +335,24 @@ void Machine::step_internal(bool skip_break) {
     enum Status stat_prev = stat;
     set_status(ST_BUSY);
     emit tick();
+    // Views are refreshed once per batch, painting them after each step throttles the simulation.
+    // TODO: Run batches in a simulation thread, see docs/developer/gui-updates.md.
+    const bool batched = time_chunk != 0 && !skip_break;
     try {
+        QSignalBlocker regs_blocker(batched ? regs : nullptr);
+        QSignalBlocker controlst_blocker(batched ? controlst : nullptr);
+        cr->set_step_notification(!batched);
         QTime start_time = QTime::currentTime();
         do {
             cr->step(skip_break);
-        } while (time_chunk != 0 && stat == ST_BUSY && !skip_break
+            if (machine_config.idle_fast_forward() && cr->is_idle()) { fast_forward_idle(); }
+        } while (batched && stat == ST_BUSY
                  && start_time.msecsTo(QTime::currentTime()) < (int)time_chunk);
+        cr->set_step_notification(true);
     } catch (SimulatorException &e) {
+        cr->set_step_notification(true);
+        report_direct_reads();
+        if (batched) { emit batch_done(); }
         run_t->stop();
         set_status(ST_TRAPPED);
         emit program_trap(e);
@@ -355,6 +367,8 @@ void Machine::step_internal(bool skip_break) {
             set_status(stat_prev);
         }
     }
+    report_direct_reads();
+    if (batched) { emit batch_done(); }
     emit post_tick();
 }
 
@@ -362,6 +376,21 @@ void Machine::step() {
     step_internal(true);
 }
 
+void Machine::report_direct_reads() {
+    cch_program->report_direct_reads();
+    cch_data->report_direct_reads();
+    cch_level2->report_direct_reads();
+}
+
+void Machine::fast_forward_idle() {
+    // Only the timer event can be scheduled in advance. Serial port and software interrupts are
+    // raised directly by the host or guest actions which cause them.
+    uint64_t mie = controlst->read_internal(CSR::Id::MIE).as_u64();
+    if (aclint_mtimer != nullptr && (mie & (1ULL << aclint_mtimer->irq_level()))) {
+        aclint_mtimer->skip_to_next_event();
+    }
+}
+
 void Machine::step_timer() {
     step_internal();
 }
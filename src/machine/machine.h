@@ -97,6 +97,15 @@ signals:
     void status_change(enum machine::Machine::Status st);
     void tick();      // Time tick
     void post_tick(); // Emitted after tick to allow updates
+    /**
+     * Batch of steps run with time chunk is done. Core, registers and CSRs do not notify about
+     * individual steps of the batch, views of the state should be refreshed as a whole.
+     *
+     * Batches run in the thread of the machine (the GUI thread), views read the machine state
+     * directly once the batch returns. It is emitted just before `post_tick`, views refreshed on
+     * every tick need not to connect to it.
+     */
+    void batch_done();
     void set_interrupt_signal(uint irq_num, bool active);
 
 private slots:
@@ -104,6 +113,9 @@ private slots:
 
 private:
     void step_internal(bool skip_break = false);
+    void fast_forward_idle();
+    /** Emit statistics of cache bypassing reads accumulated by the last batch. */
+    void report_direct_reads();
     MachineConfig machine_config;
 
     Registers *regs = nullptr;
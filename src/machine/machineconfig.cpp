@@ -20,6 +20,7 @@ using namespace machine;
 #define DF_MEM_ACC_LEVEL2 2
 #define DF_MEM_ACC_BURST_ENABLE false
 #define DF_ELF QString("")
+#define DF_IDLE_FAST_FORWARD false
 //////////////////////////////////////////////////////////////////////////////
 /// Default config of CacheConfig
 #define DFC_EN false
@@ -169,6 +170,7 @@ MachineConfig::MachineConfig() {
     osem_exception_stop = true;
     osem_fs_root = "";
     res_at_compile = true;
+    idle_ff = DF_IDLE_FAST_FORWARD;
     elf_path = DF_ELF;
     cch_program = CacheConfig();
     cch_data = CacheConfig();
@@ -196,6 +198,7 @@ MachineConfig::MachineConfig(const MachineConfig *config) {
     osem_exception_stop = config->osemu_exception_stop();
     osem_fs_root = config->osemu_fs_root();
     res_at_compile = config->reset_at_compile();
+    idle_ff = config->idle_fast_forward();
     elf_path = config->elf();
     cch_program = config->cache_program();
     cch_data = config->cache_data();
@@ -232,6 +235,7 @@ MachineConfig::MachineConfig(const QSettings *sts, const QString &prefix) {
     osem_exception_stop = sts->value(N("OsemuExceptionStop"), true).toBool();
     osem_fs_root = sts->value(N("OsemuFilesystemRoot"), "").toString();
     res_at_compile = sts->value(N("ResetAtCompile"), true).toBool();
+    idle_ff = sts->value(N("IdleFastForward"), DF_IDLE_FAST_FORWARD).toBool();
     elf_path = sts->value(N("Elf"), DF_ELF).toString();
     cch_program = CacheConfig(sts, N("ProgramCache_"));
     cch_data = CacheConfig(sts, N("DataCache_"));
@@ -256,6 +260,7 @@ void MachineConfig::store(QSettings *sts, const QString &prefix) {
     sts->setValue(N("OsemuExceptionStop"), osemu_exception_stop());
     sts->setValue(N("OsemuFilesystemRoot"), osemu_fs_root());
     sts->setValue(N("ResetAtCompile"), reset_at_compile());
+    sts->setValue(N("IdleFastForward"), idle_fast_forward());
     sts->setValue(N("Elf"), elf_path);
     cch_program.store(sts, N("ProgramCache_"));
     cch_data.store(sts, N("DataCache_"));
@@ -390,6 +395,10 @@ void MachineConfig::set_reset_at_compile(bool v) {
     res_at_compile = v;
 }
 
+void MachineConfig::set_idle_fast_forward(bool v) {
+    idle_ff = v;
+}
+
 void MachineConfig::set_elf(QString path) {
     elf_path = std::move(path);
 }
@@ -488,6 +497,10 @@ bool MachineConfig::reset_at_compile() const {
     return res_at_compile;
 }
 
+bool MachineConfig::idle_fast_forward() const {
+    return idle_ff;
+}
+
 QString MachineConfig::elf() const {
     return elf_path;
 }
@@ -535,7 +548,7 @@ bool MachineConfig::operator==(const MachineConfig &c) const {
            && CMP(memory_execute_protection) && CMP(memory_write_protection)
            && CMP(memory_access_time_read) && CMP(memory_access_time_write)
            && CMP(memory_access_time_burst) && CMP(memory_access_time_level2)
-           && CMP(memory_access_enable_burst)
+           && CMP(memory_access_enable_burst) && CMP(idle_fast_forward)
            && CMP(elf) && CMP(cache_program)
            && CMP(cache_data) && CMP(cache_level2);
 #undef CMP
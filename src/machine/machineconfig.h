@@ -121,6 +121,8 @@ public:
     void set_osemu_fs_root(QString v);
     // reset machine befor internal compile/reload after external make
     void set_reset_at_compile(bool);
+    // skip simulated time to the next timer event when core waits for an interrupt
+    void set_idle_fast_forward(bool);
     // Set path to source elf file. This has to be set before core is
     // initialized.
     void set_elf(QString path);
@@ -150,6 +152,7 @@ public:
     bool osemu_exception_stop() const;
     QString osemu_fs_root() const;
     bool reset_at_compile() const;
+    bool idle_fast_forward() const;
     QString elf() const;
     const CacheConfig &cache_program() const;
     const CacheConfig &cache_data() const;
@@ -174,6 +177,7 @@ private:
     bool osem_enable, osem_known_syscall_stop, osem_unknown_syscall_stop;
     bool osem_interrupt_stop, osem_exception_stop;
     bool res_at_compile;
+    bool idle_ff;
     QString osem_fs_root;
     QString elf_path;
     CacheConfig cch_program, cch_data, cch_level2;
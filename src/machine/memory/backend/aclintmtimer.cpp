@@ -38,6 +38,19 @@ uint64_t AclintMtimer::mtime_fetch_current() const {
     return mtime_last_current_fetch;
 }
 
+uint AclintMtimer::irq_level() const {
+    return mtimer_irq_level;
+}
+
+bool AclintMtimer::skip_to_next_event() {
+    mtime_fetch_current();
+    if (mtimer_irq_active || mtimecmp_value[0] == UINT64_MAX) { return false; }
+
+    uint64_t mtime = mtime_last_current_fetch + mtime_user_offset;
+    if (mtimecmp_value[0] >= mtime) { mtime_user_offset += mtimecmp_value[0] - mtime + 1; }
+    return update_mtimer_irq();
+}
+
 bool AclintMtimer::update_mtimer_irq() {
     bool active;
 
@@ -39,6 +39,15 @@ namespace machine { namespace aclint {
 
     public:
         uint64_t mtime_fetch_current() const;
+        uint irq_level() const;
+
+        /**
+         * Advance mtime just past the nearest mtimecmp, as if the host had stalled until then.
+         * Used to fast-forward an idle core. Time is only ever moved forward.
+         *
+         * @return true if the timer interrupt has been raised
+         */
+        bool skip_to_next_event();
 
         WriteResult
         write(Offset destination, const void *source, size_t size, WriteOptions options) override;
@@ -6,6 +6,9 @@
 #include "memory/memory_utils.h"
 
 #include <QObject>
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 // Shortcut for enum class values, type is obvious from context.
 using ae = machine::AccessEffects;
@@ -94,12 +97,44 @@ public:
      */
     [[nodiscard]] virtual enum LocationStatus location_status(Offset offset) const = 0;
 
+    /**
+     * Find host memory holding the content at given offset.
+     *
+     * Only plain storage without side effects on read may return a non-null
+     * `data`. The pointer must stay valid until `invalidate_host_pages` is
+     * called. Default: the whole device is accessible only via `read`.
+     */
+    [[nodiscard]] virtual HostPage lookup_host_page(Offset offset) const;
+
+    /**
+     * Generation of host pages of a bus the device is connected to.
+     * The device bumps it, when its host pages change.
+     */
+    void attach_host_page_generation(const std::shared_ptr<HostPageGeneration> &generation);
+    void detach_host_page_generation(const HostPageGeneration *generation);
+
+    /**
+     * Drop content of a range, it reads as zero (or as given by `source`) afterwards.
+     *
+     * Storage may release the range instead of writing it. Default: the new content is written
+     * immediately.
+     *
+     * @param start         relative index of the first discarded byte
+     * @param size          number of bytes to discard
+     * @param source        lazy content of the range, may be empty
+     */
+    virtual void discard(Offset start, size_t size, const ContentSource &source);
+
     /**
      * Endian of the simulated CPU/memory system.
      * @see BackendMemory docs
      */
     const Endian simulated_machine_endian;
 
+protected:
+    /** Invalidate host pages handed out by all buses the device is connected to. */
+    void invalidate_host_pages() const;
+
 signals:
     /**
      * Notify upper layer about a change in managed physical memory of periphery
@@ -114,11 +149,51 @@ signals:
         uint32_t start_addr,
         uint32_t last_addr,
         AccessEffects type) const;
+
+private:
+    std::vector<std::shared_ptr<HostPageGeneration>> host_page_generations;
 };
 
 inline BackendMemory::BackendMemory(Endian simulated_machine_endian)
     : simulated_machine_endian(simulated_machine_endian) {}
 
+inline HostPage BackendMemory::lookup_host_page(Offset offset) const {
+    UNUSED(offset)
+    return { .start = 0, .size = UINT64_MAX };
+}
+
+inline void BackendMemory::attach_host_page_generation(
+    const std::shared_ptr<HostPageGeneration> &generation) {
+    if (std::find(host_page_generations.begin(), host_page_generations.end(), generation)
+        == host_page_generations.end()) {
+        host_page_generations.push_back(generation);
+    }
+}
+
+inline void BackendMemory::detach_host_page_generation(const HostPageGeneration *generation) {
+    host_page_generations.erase(
+        std::remove_if(
+            host_page_generations.begin(), host_page_generations.end(),
+            [generation](const auto &attached) { return attached.get() == generation; }),
+        host_page_generations.end());
+}
+
+inline void BackendMemory::invalidate_host_pages() const {
+    for (const auto &generation : host_page_generations) {
+        generation->bump();
+    }
+}
+
+inline void BackendMemory::discard(Offset start, size_t size, const ContentSource &source) {
+    std::array<byte, 256> buffer;
+    for (uint64_t done = 0; done < size; done += buffer.size()) {
+        const size_t part = std::min<uint64_t>(size - done, buffer.size());
+        buffer.fill(0);
+        if (source) { source(done, buffer.data(), part); }
+        write(start + done, buffer.data(), part, { .type = ae::INTERNAL });
+    }
+}
+
 } // namespace machine
 
 #endif // BACKEND_MEMORY_H
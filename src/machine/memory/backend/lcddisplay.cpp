@@ -16,7 +16,15 @@ LcdDisplay::LcdDisplay(Endian simulated_machine_endian)
     , fb_width(480)
     , fb_height(320)
     , fb_bits_per_pixel(16)
-    , fb_data(get_fb_size_bytes(), 0) {}
+    , fb_data(get_fb_size_bytes(), 0) {
+    frame_timer.setSingleShot(true);
+    frame_timer.setInterval(FRAME_INTERVAL_MS);
+    connect(&frame_timer, &QTimer::timeout, this, [this]() {
+        QRect dirty = dirty_rect;
+        dirty_rect = QRect();
+        emit frame_update(dirty);
+    });
+}
 
 LcdDisplay::~LcdDisplay() = default;
 
@@ -97,24 +105,17 @@ bool LcdDisplay::write_raw_pixel(Offset destination, uint16_t value) {
     std::tie(x, y) = get_pixel_from_address(destination);
 
     const uint32_t last_addr = destination + 1;
-    uint32_t pixel_addr;
-    uint16_t pixel_data;
-    uint r, g, b;
-
-    while ((pixel_addr = get_address_from_pixel(x, y)) <= last_addr) {
-        memcpy(&pixel_data, &fb_data[pixel_addr], sizeof(pixel_data));
-
-        r = ((pixel_data >> 11u) & 0x1fu) << 3u;
-        g = ((pixel_data >> 5u) & 0x3fu) << 2u;
-        b = ((pixel_data >> 0u) & 0x1fu) << 3u;
 
-        emit pixel_update(x, y, r, g, b);
+    while (get_address_from_pixel(x, y) <= last_addr) {
+        dirty_rect |= QRect(x, y, 1, 1);
 
         if (++x >= fb_width) {
             x = 0;
             y++;
         }
     }
+    // Changes are collected and announced once per frame.
+    if (!frame_timer.isActive()) { frame_timer.start(); }
 
     emit write_notification(destination, value);
 
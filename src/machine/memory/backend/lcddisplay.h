@@ -8,6 +8,8 @@
 
 #include <QMap>
 #include <QObject>
+#include <QRect>
+#include <QTimer>
 #include <cstdint>
 
 namespace machine {
@@ -21,7 +23,11 @@ public:
 signals:
     void write_notification(Offset offset, uint32_t value) const;
     void read_notification(Offset offset, uint32_t value) const;
-    void pixel_update(size_t x, size_t y, uint r, uint g, uint b);
+    /**
+     * Region of the framebuffer changed since the last notification.
+     * Emitted at most once per frame interval.
+     */
+    void frame_update(QRect dirty);
 
 public:
     WriteResult write(
@@ -52,6 +58,14 @@ public:
         return fb_height;
     }
 
+    /**
+     * Framebuffer pixels in RGB565 format in host endian (QImage::Format_RGB16),
+     * lines are `get_fb_line_size()` bytes apart.
+     */
+    [[nodiscard]] inline const byte *get_fb_data() const { return fb_data.data(); }
+
+    [[nodiscard]] size_t get_fb_line_size() const;
+
 private:
     /** Endian internal registers of the periphery (framebuffer) use. */
     static constexpr Endian internal_endian = NATIVE_ENDIAN;
@@ -62,7 +76,6 @@ private:
     /** Write HW register - allows only 32bit aligned access */
     bool write_raw_pixel(Offset destination, uint16_t value);
 
-    [[nodiscard]] size_t get_fb_line_size() const;
     [[nodiscard]] size_t get_fb_size_bytes() const;
     [[nodiscard]] size_t get_address_from_pixel(size_t x, size_t y) const;
     [[nodiscard]] std::tuple<size_t, size_t> get_pixel_from_address(size_t address) const;
@@ -71,6 +84,12 @@ private:
     const size_t fb_height; //> Height in pixels
     const size_t fb_bits_per_pixel;
     std::vector<byte> fb_data;
+
+    /** Approximately 60 frames per second. */
+    static constexpr int FRAME_INTERVAL_MS = 16;
+    /** Pixels changed since the last frame_update. */
+    QRect dirty_rect;
+    QTimer frame_timer;
 };
 
 } // namespace machine
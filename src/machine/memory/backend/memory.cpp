@@ -120,6 +120,10 @@ constexpr size_t get_tree_row(size_t offset, size_t i) {
            >> tree_row_bit_offset(i);
 }
 
+size_t get_section_offset_mask(size_t addr) {
+    return addr & generate_mask(MEMORY_SECTION_BITS, 0);
+}
+
 Memory::Memory() : BackendMemory(BIG) {
     // This is dummy constructor for qt internal uses only.
     this->mt_root = nullptr;
@@ -131,24 +135,30 @@ Memory::Memory(Endian simulated_machine_endian)
 }
 
 Memory::Memory(const Memory &other)
-    : BackendMemory(other.simulated_machine_endian) {
+    : BackendMemory(other.simulated_machine_endian)
+    , lazy_ranges(other.lazy_ranges) {
     this->mt_root = copy_section_tree(other.get_memory_tree_root(), 0);
 }
 
 Memory::~Memory() {
+    invalidate_host_pages();
     free_section_tree(this->mt_root, 0);
     delete[] this->mt_root;
 }
 
 void Memory::reset() {
+    invalidate_host_pages();
     free_section_tree(this->mt_root, 0);
     delete[] this->mt_root;
     this->mt_root = allocate_section_tree();
+    lazy_ranges.clear();
 }
 
 void Memory::reset(const Memory &m) {
+    invalidate_host_pages();
     free_section_tree(this->mt_root, 0);
     this->mt_root = copy_section_tree(m.get_memory_tree_root(), 0);
+    lazy_ranges = m.lazy_ranges;
 }
 
 MemorySection *Memory::get_section(size_t offset, bool create) const {
@@ -175,14 +185,13 @@ MemorySection *Memory::get_section(size_t offset, bool create) const {
         }
         w[row_num].sec
             = new MemorySection(MEMORY_SECTION_SIZE, simulated_machine_endian);
+        fill_lazy_content(w[row_num].sec, offset - get_section_offset_mask(offset));
+        // Direct readers may have cached this section as unallocated.
+        invalidate_host_pages();
     }
     return w[row_num].sec;
 }
 
-size_t get_section_offset_mask(size_t addr) {
-    return addr & generate_mask(MEMORY_SECTION_BITS, 0);
-}
-
 WriteResult Memory::write(
     Offset destination,
     const void *source,
@@ -209,8 +218,12 @@ ReadResult Memory::read(
         [this](
             void *_destination, Offset _source, size_t _size,
             ReadOptions _options) -> ReadResult {
-            MemorySection *section = this->get_section(_source, false);
+            MemorySection *section
+                = this->get_section(_source, has_lazy_content(_source));
             if (section == nullptr) {
+                // Block reads may continue into an allocated section.
+                _size = std::min(
+                    _size, MEMORY_SECTION_SIZE - get_section_offset_mask(_source));
                 memset(_destination, 0, _size);
                 // TODO Warning read of uninitialized memory
                 return { .n_bytes = _size };
@@ -222,6 +235,123 @@ ReadResult Memory::read(
         });
 }
 
+HostPage Memory::lookup_host_page(Offset offset) const {
+    const MemorySection *section = get_section(offset, false);
+    return { .start = offset - get_section_offset_mask(offset),
+             .size = MEMORY_SECTION_SIZE,
+             .data = (section != nullptr) ? section->data() : nullptr };
+}
+
+void Memory::discard(Offset start, size_t size, const ContentSource &source) {
+    if (size == 0) { return; }
+    drop_lazy_ranges(start, size);
+    const Offset end = start + size;
+    const Offset inner_start = std::min(
+        end, (start + MEMORY_SECTION_SIZE - 1) & ~(MEMORY_SECTION_SIZE - 1));
+    const Offset inner_end
+        = std::max(inner_start, end & ~(MEMORY_SECTION_SIZE - 1));
+    discard_in_section(start, inner_start - start, 0, source);
+    discard_in_section(inner_end, end - inner_end, inner_end - start, source);
+    release_sections(inner_start, inner_end - inner_start);
+    if (source) { lazy_ranges.insert({ start, { size, source } }); }
+    // Direct readers may hold pointers to the released sections.
+    invalidate_host_pages();
+}
+
+void Memory::release_sections(Offset start, size_t size) {
+    const Offset end = start + size;
+    Offset offset = start;
+    while (offset < end) {
+        size_t step = MEMORY_SECTION_SIZE;
+        union MemoryTree *w = this->mt_root;
+        for (size_t i = 0; i < (MEMORY_TREE_DEPTH - 1); i++) {
+            w = w[get_tree_row(offset, i)].subtree;
+            if (w == nullptr) {
+                // Nothing is allocated in the whole subtree, skip it at once.
+                step = size_t(1) << tree_row_bit_offset(i);
+                break;
+            }
+        }
+        if (w != nullptr) {
+            MemorySection *&section = w[get_tree_row(offset, MEMORY_TREE_DEPTH - 1)].sec;
+            delete section;
+            section = nullptr;
+        }
+        offset = (offset & ~(step - 1)) + step;
+    }
+}
+
+void Memory::discard_in_section(
+    Offset start,
+    size_t size,
+    uint64_t range_offset,
+    const ContentSource &source) {
+    if (size == 0) { return; }
+    MemorySection *section = get_section(start, false);
+    if (section == nullptr) {
+        // Unallocated part is filled in when the section is allocated.
+        return;
+    }
+    byte buffer[MEMORY_SECTION_SIZE] = {};
+    if (source) { source(range_offset, buffer, size); }
+    section->write(get_section_offset_mask(start), buffer, size, {});
+}
+
+void Memory::drop_lazy_ranges(Offset start, size_t size) {
+    const Offset end = start + size;
+    auto iter = lazy_ranges.upper_bound(start);
+    if (iter != lazy_ranges.begin()) { --iter; }
+    while (iter != lazy_ranges.end() && iter->first < end) {
+        const Offset range_start = iter->first;
+        const Offset range_end = range_start + iter->second.size;
+        if (range_end <= start) {
+            ++iter;
+            continue;
+        }
+        const ContentSource source = std::move(iter->second.source);
+        iter = lazy_ranges.erase(iter);
+        // Parts outside of the dropped range are kept.
+        if (range_start < start) {
+            lazy_ranges.insert({ range_start, { start - range_start, source } });
+        }
+        if (range_end > end) {
+            const uint64_t shift = end - range_start;
+            lazy_ranges.insert(
+                { end,
+                  { range_end - end,
+                    [source, shift](uint64_t range_offset, byte *destination, size_t size) {
+                        source(range_offset + shift, destination, size);
+                    } } });
+        }
+    }
+}
+
+bool Memory::has_lazy_content(Offset offset) const {
+    if (lazy_ranges.empty()) { return false; }
+    const Offset section_start = offset - get_section_offset_mask(offset);
+    auto iter = lazy_ranges.upper_bound(section_start);
+    if (iter != lazy_ranges.end() && iter->first < section_start + MEMORY_SECTION_SIZE) {
+        return true;
+    }
+    if (iter == lazy_ranges.begin()) { return false; }
+    --iter;
+    return iter->first + iter->second.size > section_start;
+}
+
+void Memory::fill_lazy_content(MemorySection *section, Offset section_start) const {
+    const Offset section_end = section_start + MEMORY_SECTION_SIZE;
+    auto iter = lazy_ranges.upper_bound(section_start);
+    if (iter != lazy_ranges.begin()) { --iter; }
+    for (; iter != lazy_ranges.end() && iter->first < section_end; ++iter) {
+        const Offset start = std::max(iter->first, section_start);
+        const Offset end = std::min(iter->first + iter->second.size, section_end);
+        if (start >= end) { continue; }
+        byte buffer[MEMORY_SECTION_SIZE] = {};
+        iter->second.source(start - iter->first, buffer, end - start);
+        section->write(start - section_start, buffer, end - start, {});
+    }
+}
+
 uint32_t Memory::get_change_counter() const {
     return change_counter;
 }
@@ -11,6 +11,7 @@
 
 #include <QObject>
 #include <cstdint>
+#include <map>
 
 namespace machine {
 
@@ -101,14 +102,40 @@ public:
 
     [[nodiscard]] LocationStatus location_status(Offset offset) const override;
 
+    /** Allocated sections are exposed directly, one section per page. */
+    [[nodiscard]] HostPage lookup_host_page(Offset offset) const override;
+
+    /**
+     * Sections inside the range are released, sections at its ends are
+     * cleared. Lazy content is filled in when a section of the range is
+     * allocated again.
+     */
+    void discard(Offset start, size_t size, const ContentSource &source) override;
+
     bool operator==(const Memory &) const;
     bool operator!=(const Memory &) const;
 
     [[nodiscard]] const union MemoryTree *get_memory_tree_root() const;
 
 private:
+    struct LazyRange {
+        size_t size;
+        ContentSource source;
+    };
+
     union MemoryTree *mt_root;
+    /** Lazy content of discarded ranges by start offset, ranges do not overlap. */
+    std::map<Offset, LazyRange> lazy_ranges;
     uint32_t change_counter = 0;
+    void release_sections(Offset start, size_t size);
+    void discard_in_section(
+        Offset start,
+        size_t size,
+        uint64_t range_offset,
+        const ContentSource &source);
+    void drop_lazy_ranges(Offset start, size_t size);
+    [[nodiscard]] bool has_lazy_content(Offset offset) const;
+    void fill_lazy_content(MemorySection *section, Offset section_start) const;
     static union MemoryTree *allocate_section_tree();
     static void free_section_tree(union MemoryTree *, size_t depth);
     static bool compare_section_tree(
@@ -8,6 +8,7 @@
 #include "tests/utils/integer_decomposition.h"
 
 #include <cinttypes>
+#include <vector>
 
 using namespace machine;
 
@@ -369,4 +370,215 @@ void TestMemory::memory_memtest() {
     }
 }
 
+/**
+ * Block transfers span several memory sections, some of them not allocated.
+ */
+void TestMemory::memory_block() {
+    Memory mem(LITTLE);
+    TrivialBus bus(&mem);
+    const Address base(3 * MEMORY_SECTION_SIZE - 5);
+    const size_t size = 2 * MEMORY_SECTION_SIZE + 10;
+
+    // Only the last touched section is allocated before the block read.
+    bus.write_u8(base + size - 1, 0x5a);
+    std::vector<uint8_t> data(size, 0xff);
+    bus.read_block(data.data(), base, size);
+    for (size_t i = 0; i < size - 1; i++) {
+        QCOMPARE(data[i], uint8_t(0));
+    }
+    QCOMPARE(data[size - 1], uint8_t(0x5a));
+
+    for (size_t i = 0; i < size; i++) {
+        data[i] = uint8_t(i * 7);
+    }
+    QVERIFY(bus.write_block(base, data.data(), size));
+    QVERIFY(!bus.write_block(base, data.data(), size));
+    for (size_t i = 0; i < size; i++) {
+        QCOMPARE(bus.read_u8(base + i), uint8_t(i * 7));
+    }
+    std::vector<uint8_t> readback(size);
+    bus.read_block(readback.data(), base, size);
+    QCOMPARE(readback, data);
+}
+
+/**
+ * Block transfers through the bus are split at range boundaries and gaps.
+ */
+void TestMemory::memory_bus_block() {
+    MemoryDataBus bus(LITTLE);
+    Memory first(LITTLE);
+    Memory second(LITTLE);
+    bus.insert_device_to_range(&first, 0x1000_addr, 0x10ff_addr, false);
+    bus.insert_device_to_range(&second, 0x1200_addr, 0x12ff_addr, false);
+
+    const Address base = 0xf80_addr;
+    const size_t size = 0x400;
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = uint8_t(i * 3 + 1);
+    }
+    // The block starts in a gap, writes there are ignored.
+    QVERIFY(bus.write_block(base, data.data(), size));
+    // Nothing was written past the end of the first range.
+    QCOMPARE(memory_read_u8(&first, 0x100), uint8_t(0));
+    QCOMPARE(memory_read_u8(&first, 0x0), data[0x80]);
+    QCOMPARE(memory_read_u8(&second, 0xff), data[0x37f]);
+
+    std::vector<uint8_t> readback(size, 0xff);
+    bus.read_block(readback.data(), base, size);
+    for (size_t i = 0; i < size; i++) {
+        const uint64_t address = base.get_raw() + i;
+        const bool mapped = (address >= 0x1000 && address <= 0x10ff)
+                            || (address >= 0x1200 && address <= 0x12ff);
+        QCOMPARE(readback[i], mapped ? data[i] : uint8_t(0));
+    }
+
+    // Allocated sections are direct spans, the gaps are merged into single spans.
+    const std::vector<MemorySpan> spans = bus.get_spans(base, size);
+    QCOMPARE(spans.size(), size_t(5));
+    QVERIFY(spans[0].data == nullptr);
+    QCOMPARE(spans[0].size, size_t(0x80));
+    QVERIFY(spans[1].data != nullptr);
+    QCOMPARE(spans[1].address, 0x1000_addr);
+    QCOMPARE(spans[1].size, size_t(0x100));
+    QVERIFY(spans[2].data == nullptr);
+    QCOMPARE(spans[2].size, size_t(0x100));
+    QVERIFY(spans[3].data != nullptr);
+    QVERIFY(spans[4].data == nullptr);
+    QCOMPARE(spans[4].address, 0x1300_addr);
+}
+
+void TestMemory::memory_host_page() {
+    Memory mem(BIG);
+    TrivialBus bus(&mem);
+
+    // Unallocated section has no host page and reads as zero.
+    QVERIFY(bus.lookup_host_page(0x104_addr).data == nullptr);
+    QCOMPARE(bus.read_u32(0x100_addr), uint32_t(0));
+
+    // Allocation invalidates the cached negative lookup.
+    bus.write_u32(0x100_addr, 0x12345678);
+    bus.write_u32(0x104_addr, 0x9abcdef0);
+    HostPage page = bus.lookup_host_page(0x104_addr);
+    QVERIFY(page.data != nullptr);
+    QCOMPARE(page.start, uint64_t(0x100));
+    QCOMPARE(page.size, uint64_t(MEMORY_SECTION_SIZE));
+    QCOMPARE(bus.read_u32(0x100_addr), uint32_t(0x12345678));
+    QCOMPARE(bus.read_u16(0x104_addr), uint16_t(0x9abc));
+    QCOMPARE(bus.read_u8(0x107_addr), uint8_t(0xf0));
+    QCOMPARE(bus.read_u64(0x100_addr), uint64_t(0x123456789abcdef0));
+    // Misaligned access takes the regular path.
+    QCOMPARE(bus.read_u32(0x102_addr), uint32_t(0x56789abc));
+
+    mem.reset();
+    QCOMPARE(bus.read_u32(0x100_addr), uint32_t(0));
+
+    // Device pages are translated to bus addresses and clipped to the range.
+    MemoryDataBus data_bus(BIG);
+    auto *ram = new Memory(BIG);
+    data_bus.insert_device_to_range(ram, 0x1080_addr, 0x10ff_addr, true);
+    data_bus.write_u32(0x1080_addr, 0xcafebabe);
+    page = data_bus.lookup_host_page(0x1084_addr);
+    QVERIFY(page.data != nullptr);
+    QCOMPARE(page.start, uint64_t(0x1080));
+    QCOMPARE(page.size, uint64_t(0x80));
+    QCOMPARE(data_bus.read_u32(0x1080_addr), uint32_t(0xcafebabe));
+    QCOMPARE(data_bus.read_u32(0x1100_addr), uint32_t(0));
+
+    data_bus.clean_range(0x1000_addr, 0x1fff_addr);
+    QCOMPARE(data_bus.read_u32(0x1080_addr), uint32_t(0));
+
+    // Changes in one hierarchy do not invalidate pages of another one.
+    bus.write_u32(0x100_addr, 0x12345678);
+    page = bus.lookup_host_page(0x100_addr);
+    const HostPageGeneration *generation = page.generation_source;
+    QVERIFY(generation != nullptr);
+    const uint32_t current = generation->get();
+    Memory other(BIG);
+    TrivialBus other_bus(&other);
+    other_bus.write_u32(0x200_addr, 1);
+    QVERIFY(other_bus.lookup_host_page(0x200_addr).generation_source != generation);
+    QCOMPARE(generation->get(), current);
+    mem.reset();
+    QVERIFY(generation->get() != current);
+}
+
+/**
+ * Discarded sections are released, lazy content is filled in on the first touch.
+ */
+void TestMemory::memory_discard() {
+    Memory mem(LITTLE);
+    TrivialBus bus(&mem);
+    const Address base(2 * MEMORY_SECTION_SIZE);
+    const size_t size = 4 * MEMORY_SECTION_SIZE;
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = uint8_t(i * 5 + 3);
+    }
+    bus.write_block(base, data.data(), size);
+
+    // Sections inside the range are released, the ends are cleared in place.
+    const Address start = base + MEMORY_SECTION_SIZE / 2;
+    const size_t length = 2 * MEMORY_SECTION_SIZE;
+    bus.discard(start, length, {});
+    QVERIFY(mem.get_section(start.get_raw(), false) != nullptr);
+    QVERIFY(mem.get_section(start.get_raw() + MEMORY_SECTION_SIZE, false) == nullptr);
+    QVERIFY(mem.get_section(start.get_raw() + length, false) != nullptr);
+    std::vector<uint8_t> readback(size);
+    bus.read_block(readback.data(), base, size);
+    for (size_t i = 0; i < size; i++) {
+        const bool discarded = i >= MEMORY_SECTION_SIZE / 2 && i < MEMORY_SECTION_SIZE / 2 + length;
+        QCOMPARE(readback[i], discarded ? uint8_t(0) : data[i]);
+    }
+
+    // Content source is not called until the range is touched.
+    size_t requested = 0;
+    auto source = [&requested](uint64_t range_offset, byte *destination, size_t count) {
+        requested += count;
+        for (size_t i = 0; i < count; i++) {
+            destination[i] = uint8_t(range_offset + i + 1);
+        }
+    };
+    const Address lazy = 0x10000_addr;
+    bus.discard(lazy, 3 * MEMORY_SECTION_SIZE, source);
+    QCOMPARE(requested, size_t(0));
+    QVERIFY(mem.get_section(lazy.get_raw(), false) == nullptr);
+    QCOMPARE(bus.read_u8(lazy + MEMORY_SECTION_SIZE + 4), uint8_t(MEMORY_SECTION_SIZE + 5));
+    QCOMPARE(requested, size_t(MEMORY_SECTION_SIZE));
+    // A write allocates the section with its content first.
+    bus.write_u8(lazy, 0xaa);
+    QCOMPARE(bus.read_u8(lazy), uint8_t(0xaa));
+    QCOMPARE(bus.read_u8(lazy + 1), uint8_t(2));
+
+    // Discarding a part of the lazy range keeps the rest of it.
+    bus.discard(lazy + 2 * MEMORY_SECTION_SIZE, 16, {});
+    QCOMPARE(bus.read_u8(lazy + 2 * MEMORY_SECTION_SIZE + 15), uint8_t(0));
+    QCOMPARE(
+        bus.read_u8(lazy + 2 * MEMORY_SECTION_SIZE + 16),
+        uint8_t(2 * MEMORY_SECTION_SIZE + 17));
+
+    // Bytes the source does not fill read as zero.
+    bus.discard(0x20000_addr, MEMORY_SECTION_SIZE, [](uint64_t, byte *destination, size_t) {
+        destination[0] = 0x11;
+    });
+    QCOMPARE(bus.read_u16(0x20000_addr), uint16_t(0x0011));
+
+    // Discarded range is announced as an external change.
+    MemoryDataBus data_bus(LITTLE);
+    data_bus.insert_device_to_range(&mem, 0x30000_addr, 0x3ffff_addr, false);
+    std::vector<std::pair<uint64_t, uint64_t>> notified;
+    QObject::connect(
+        &data_bus, &FrontendMemory::external_change_notify,
+        [&](const FrontendMemory *issuing_memory, Address start_addr, Address last_addr,
+            AccessEffects) {
+            QVERIFY(issuing_memory == &data_bus);
+            notified.emplace_back(start_addr.get_raw(), last_addr.get_raw());
+        });
+    // Only the mapped part of the range is discarded.
+    data_bus.discard(0x3ff00_addr, 0x200, {});
+    QCOMPARE(notified.size(), size_t(1));
+    QCOMPARE(notified[0].first, uint64_t(0x3ff00));
+    QCOMPARE(notified[0].second, uint64_t(0x3ffff));
+}
+
 QTEST_APPLESS_MAIN(TestMemory)
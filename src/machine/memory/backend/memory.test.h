@@ -22,6 +22,10 @@ private slots:
     static void memory_read_ctl();
     static void memory_memtest_data();
     static void memory_memtest();
+    static void memory_block();
+    static void memory_bus_block();
+    static void memory_host_page();
+    static void memory_discard();
 };
 
 #endif // MEMORY_TEST_H
@@ -135,7 +135,10 @@ uint32_t SerialPort::read_reg(Offset source, AccessEffects type) const {
         rx_queue_check_internal();
         break;
     case SERP_TX_ST_REG_o: value = tx_st_reg; break;
-    default: WARN("Serial port - read out of range (at 0x%zu).\n", source); break;
+    default:
+        // Views of memory read the whole range, only accesses of the program are reported.
+        if (type == ae::REGULAR) { WARN("Serial port - read out of range (at 0x%zu).\n", source); }
+        break;
     }
 
     emit read_notification(source, value);
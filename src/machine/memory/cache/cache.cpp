@@ -39,6 +39,7 @@ Cache::Cache(
               .dirty = false,
               .tag = 0,
               .data = std::vector<uint32_t>(config->block_size()) }));
+    changed_lines.assign(config->associativity() * config->set_count(), false);
 }
 
 Cache::~Cache() = default;
@@ -48,28 +49,43 @@ WriteResult Cache::write(
     const void *source,
     size_t size,
     WriteOptions options) {
-    if (!cache_config.enabled() || is_in_uncached_area(destination)
-        || is_in_uncached_area(destination + size)) {
+    if (!cache_config.enabled()) {
         mem_writes++;
         emit memory_writes_update(mem_writes);
         update_all_statistics();
         return mem->write(destination, source, size, options);
     }
 
-    // FIXME: Get rid of the cast
-    // access is mostly the same for read and write but one needs to write
-    // to the address
-    const bool changed
-        = access(destination, const_cast<void *>(source), size, WRITE);
-
-    if (cache_config.write_policy() != CacheConfig::WP_BACK) {
-        mem_writes++;
-        emit memory_writes_update(mem_writes);
-        update_all_statistics();
-        return mem->write(destination, source, size, options);
+    WriteResult result;
+    const auto *src = static_cast<const byte *>(source);
+    // Parts of the access inside and outside of the uncached area are handled separately.
+    while (size > 0) {
+        const size_t part = split_at_uncached_area(destination, size);
+        if (is_in_uncached_area(destination)) {
+            mem_writes++;
+            emit memory_writes_update(mem_writes);
+            update_all_statistics();
+            result += mem->write(destination, src, part, options);
+        } else {
+            // FIXME: Get rid of the cast
+            // access is mostly the same for read and write but one needs to write
+            // to the address
+            const bool changed = access(destination, const_cast<byte *>(src), part, WRITE);
+
+            if (cache_config.write_policy() != CacheConfig::WP_BACK) {
+                mem_writes++;
+                emit memory_writes_update(mem_writes);
+                update_all_statistics();
+                result += mem->write(destination, src, part, options);
+            } else {
+                result += WriteResult { .n_bytes = part, .changed = changed };
+            }
+        }
+        destination += part;
+        src += part;
+        size -= part;
     }
-
-    return { .n_bytes = size, .changed = changed };
+    return result;
 }
 
 ReadResult Cache::read(
@@ -77,31 +93,79 @@ ReadResult Cache::read(
     Address source,
     size_t size,
     ReadOptions options) const {
-    if (!cache_config.enabled() || is_in_uncached_area(source)
-        || is_in_uncached_area(source + size)) {
+    if (!cache_config.enabled()) {
         mem_reads++;
         emit memory_reads_update(mem_reads);
         update_all_statistics();
         return mem->read(destination, source, size, options);
     }
 
-    if (options.type == ae::INTERNAL) {
-        if (!(location_status(source) & LOCSTAT_CACHED)) {
-            mem->read(destination, source, size, options);
+    ReadResult result;
+    auto *dst = static_cast<byte *>(destination);
+    while (size > 0) {
+        const size_t part = split_at_uncached_area(source, size);
+        if (is_in_uncached_area(source)) {
+            mem_reads++;
+            emit memory_reads_update(mem_reads);
+            update_all_statistics();
+            result += mem->read(dst, source, part, options);
         } else {
-            internal_read(source, destination, size);
+            if (options.type == ae::INTERNAL) {
+                internal_read(source, dst, part);
+            } else {
+                access(source, dst, part, READ);
+            }
+            result += ReadResult { .n_bytes = part };
         }
-        return {};
+        source += part;
+        dst += part;
+        size -= part;
     }
+    return result;
+}
 
-    access(source, destination, size, READ);
-
-    return {};
+void Cache::discard(Address start, size_t size, const ContentSource &source) {
+    if (cache_config.enabled() && size > 0) {
+        const uint64_t line_size = cache_config.block_size() * BLOCK_ITEM_SIZE;
+        const uint64_t first = start.get_raw();
+        const uint64_t last = first + size - 1;
+        for (size_t way = 0; way < cache_config.associativity(); way++) {
+            for (size_t row = 0; row < cache_config.set_count(); row++) {
+                CacheLine &cd = dt[way][row];
+                if (!cd.valid) { continue; }
+                const uint64_t line_first = calc_base_address(cd.tag, row).get_raw();
+                const uint64_t line_last = line_first + line_size - 1;
+                if (line_last < first || line_first > last) { continue; }
+                if (line_first < first || line_last > last) {
+                    // Content outside of the range has to be kept.
+                    kick(way, row);
+                    continue;
+                }
+                cd.valid = false;
+                cd.dirty = false;
+                change_counter++;
+                mark_line_changed(way, row);
+                replacement_policy->update_stats(way, row, false);
+            }
+        }
+    }
+    mem->discard(start, size, source);
 }
+
 bool Cache::is_in_uncached_area(Address source) const {
     return (source >= uncached_start && source <= uncached_last);
 }
 
+size_t Cache::split_at_uncached_area(Address address, size_t size) const {
+    if (is_in_uncached_area(address)) {
+        return std::min<uint64_t>(size, uint64_t(uncached_last - address) + 1);
+    }
+    if (address < uncached_start) {
+        return std::min<uint64_t>(size, uint64_t(uncached_start - address));
+    }
+    return size;
+}
+
 void Cache::flush() {
     if (!cache_config.enabled()) {
         return;
@@ -113,11 +177,10 @@ void Cache::flush() {
              set_index += 1) {
             if (dt[assoc_index][set_index].valid) {
                 kick(assoc_index, set_index);
-                emit cache_update(
-                    assoc_index, set_index, 0, false, false, 0, nullptr, false);
             }
         }
     }
+    last_access = {};
     change_counter++;
     update_all_statistics();
 }
@@ -143,6 +206,7 @@ void Cache::reset() {
     miss_read = 0;
     miss_write = 0;
     mem_reads = 0;
+    mem_reads_reported = 0;
     mem_writes = 0;
     burst_reads = 0;
     burst_writes = 0;
@@ -153,32 +217,46 @@ void Cache::reset() {
     emit memory_writes_update(get_write_count());
     update_all_statistics();
 
+    last_access = {};
     if (cache_config.enabled()) {
         for (size_t assoc_index = 0; assoc_index < cache_config.associativity();
              assoc_index++) {
             for (size_t set_index = 0; set_index < cache_config.set_count();
                  set_index++) {
-                emit cache_update(
-                    assoc_index, set_index, 0, false, false, 0, nullptr, false);
+                mark_line_changed(assoc_index, set_index);
             }
         }
     }
 }
 
 void Cache::internal_read(Address source, void *destination, size_t size) const {
-    CacheLocation loc = compute_location(source);
-    for (size_t assoc_index = 0; assoc_index < cache_config.associativity();
-         assoc_index++) {
-        if (dt[assoc_index][loc.row].valid
-            && dt[assoc_index][loc.row].tag == loc.tag) {
+    auto *dst = static_cast<byte *>(destination);
+    // Lines are looked up one by one. Cached lines may hold newer data than the memory, the rest
+    // is read from the memory, consecutive uncached lines at once.
+    Address run_start = source;
+    size_t run_size = 0;
+    while (size > 0) {
+        const CacheLocation loc = compute_location(source);
+        const size_t size_within_block = size - calculate_overflow_to_next_blocks(size, loc);
+        const size_t way = find_block_index(loc);
+        if (way < cache_config.associativity()) {
+            if (run_size > 0) {
+                mem->read(dst - run_size, run_start, run_size, { .type = ae::INTERNAL });
+                run_size = 0;
+            }
             memcpy(
-                destination,
-                (byte *)&dt[assoc_index][loc.row].data[loc.col] + loc.byte,
-                size);
-            return;
+                dst, (const byte *)&dt[way][loc.row].data[loc.col] + loc.byte, size_within_block);
+        } else {
+            if (run_size == 0) { run_start = source; }
+            run_size += size_within_block;
         }
+        source += size_within_block;
+        dst += size_within_block;
+        size -= size_within_block;
+    }
+    if (run_size > 0) {
+        mem->read(dst - run_size, run_start, run_size, { .type = ae::INTERNAL });
     }
-    memset(destination, 0, size); // TODO is this correct
 }
 
 bool Cache::access(
@@ -186,13 +264,27 @@ bool Cache::access(
     void *buffer,
     size_t size,
     AccessType access_type) const {
-    const CacheLocation loc = compute_location(address);
-    size_t way = find_block_index(loc);
+    bool changed = false;
+    auto *data = static_cast<byte *>(buffer);
+    // Access spanning multiple blocks is performed block by block. Block transfers (e.g. syscall
+    // buffers) may span thousands of blocks, so this has to be a loop.
+    while (size > 0) {
+        const CacheLocation loc = compute_location(address);
+        const size_t size_within_block = size - calculate_overflow_to_next_blocks(size, loc);
+        changed |= access_block(loc, data, size_within_block, access_type);
+        address += size_within_block;
+        data += size_within_block;
+        size -= size_within_block;
+    }
+    return changed;
+}
 
-    // check for zero because else last_affected_col can became
-    // ULONG_MAX / BLOCK_ITEM_SIZE and update can take forever
-    if (size == 0)
-        return false;
+bool Cache::access_block(
+    const CacheLocation &loc,
+    byte *buffer,
+    size_t size,
+    AccessType access_type) const {
+    size_t way = find_block_index(loc);
 
     // search failed - cache miss
     if (way >= cache_config.associativity()) {
@@ -203,18 +295,7 @@ bool Cache::access(
             miss_write++;
             emit miss_update(get_miss_count());
             update_all_statistics();
-
-            const size_t size_overflow
-                = calculate_overflow_to_next_blocks(size, loc);
-            if (size_overflow > 0) {
-                const size_t size_within_block = size - size_overflow;
-                return access(
-                    address + size_within_block,
-                    (byte *)buffer + size_within_block, size_overflow,
-                    access_type);
-            } else {
-                return false;
-            }
+            return false;
         }
 
         way = replacement_policy->select_way_to_evict(loc.row);
@@ -262,43 +343,31 @@ bool Cache::access(
 
     replacement_policy->update_stats(way, loc.row, cd.valid);
 
-    const size_t size_overflow = calculate_overflow_to_next_blocks(size, loc);
-    const size_t size_within_block = size - size_overflow;
-
     bool changed = false;
 
     if (access_type == READ) {
-        memcpy(buffer, (byte *)&cd.data[loc.col] + loc.byte, size_within_block);
+        memcpy(buffer, (byte *)&cd.data[loc.col] + loc.byte, size);
     } else if (access_type == WRITE) {
         cd.dirty = true;
-        changed = memcmp(
-                      (byte *)&cd.data[loc.col] + loc.byte, buffer,
-                      size_within_block)
-                  != 0;
+        changed = memcmp((byte *)&cd.data[loc.col] + loc.byte, buffer, size) != 0;
         if (changed) {
-            memcpy(
-                ((byte *)&cd.data[loc.col]) + loc.byte, buffer,
-                size_within_block);
+            memcpy(((byte *)&cd.data[loc.col]) + loc.byte, buffer, size);
             change_counter++;
         }
     }
     const auto last_affected_col
-        = (loc.col * BLOCK_ITEM_SIZE + loc.byte + size_within_block - 1) / BLOCK_ITEM_SIZE;
-    for (auto col = loc.col; col <= last_affected_col; col++) {
-        emit cache_update(
-            way, loc.row, col, cd.valid, cd.dirty, cd.tag, cd.data.data(),
-            access_type);
-    }
-
-    if (size_overflow > 0) {
-        // If access overlaps single cache row, perform access to next row.
-        changed |= access(
-            address + size_within_block, (byte *)buffer + size_within_block,
-            size_overflow, access_type);
-    }
+        = (loc.col * BLOCK_ITEM_SIZE + loc.byte + size - 1) / BLOCK_ITEM_SIZE;
+    last_access = { .valid = true,
+                    .write = access_type == WRITE,
+                    .way = way,
+                    .row = loc.row,
+                    .col = last_affected_col,
+                    .tag = cd.tag };
+    mark_line_changed(way, loc.row);
 
     return changed;
 }
+
 size_t Cache::calculate_overflow_to_next_blocks(
     size_t access_size,
     const CacheLocation &loc) const {
@@ -332,10 +401,34 @@ void Cache::kick(size_t way, size_t row) const {
     cd.dirty = false;
 
     change_counter++;
+    mark_line_changed(way, row);
 
     replacement_policy->update_stats(way, row, false);
 }
 
+void Cache::mark_line_changed(size_t way, size_t row) const {
+    changed_lines[way * cache_config.set_count() + row] = true;
+    if (!changes_pending) {
+        changes_pending = true;
+        emit lines_changed();
+    }
+}
+
+std::vector<bool> Cache::take_changed_lines() const {
+    std::vector<bool> taken(changed_lines.size(), false);
+    taken.swap(changed_lines);
+    changes_pending = false;
+    return taken;
+}
+
+const CacheLine &Cache::get_line(size_t way, size_t row) const {
+    return dt[way][row];
+}
+
+const Cache::AccessRecord &Cache::get_last_access() const {
+    return last_access;
+}
+
 void Cache::update_all_statistics() const {
     emit statistics_update(
         get_stall_count(), get_speed_improvement(), get_hit_rate());
@@ -366,6 +459,29 @@ CacheLocation Cache::compute_location(Address address) const {
              .byte = byte };
 }
 
+HostPage Cache::lookup_host_page(Address address) const {
+    if (cache_config.enabled()) {
+        return FrontendMemory::lookup_host_page(address);
+    }
+    HostPage page = mem->lookup_host_page(address);
+    auto counter = std::find(page.read_counters.begin(), page.read_counters.end(), nullptr);
+    if (counter == page.read_counters.end()) {
+        // Too many bypassed levels, statistics would be lost.
+        page.data = nullptr;
+    } else {
+        *counter = &mem_reads;
+    }
+    return page;
+}
+
+void Cache::report_direct_reads() const {
+    if (mem_reads != mem_reads_reported) {
+        mem_reads_reported = mem_reads;
+        emit memory_reads_update(mem_reads);
+        update_all_statistics();
+    }
+}
+
 enum LocationStatus Cache::location_status(Address address) const {
     const CacheLocation loc = compute_location(address);
 
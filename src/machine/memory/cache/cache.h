@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace machine {
 
@@ -70,6 +71,12 @@ public:
         size_t size,
         ReadOptions options) const override;
 
+    /**
+     * Lines inside the range are dropped, lines overlapping its ends are
+     * written back first.
+     */
+    void discard(Address start, size_t size, const ContentSource &source) override;
+
     uint32_t get_change_counter() const override;
 
     void flush();         // flush cache
@@ -91,6 +98,40 @@ public:
 
     enum LocationStatus location_status(Address address) const override;
 
+    /**
+     * Disabled cache passes the lookup through and counts direct reads
+     * as memory reads.
+     */
+    HostPage lookup_host_page(Address address) const override;
+
+    /**
+     * Emit statistics for reads which bypassed the cache via the host page
+     * path. Called once per simulation batch to keep the hot path
+     * signal-free.
+     */
+    void report_direct_reads() const;
+
+    /** The most recent access to the cache, used to highlight it in the visualization. */
+    struct AccessRecord {
+        /** False until the first access after reset or flush. */
+        bool valid = false;
+        bool write = false;
+        size_t way = 0;
+        size_t row = 0;
+        size_t col = 0;
+        uint64_t tag = 0;
+    };
+
+    /**
+     * Lines changed since the previous call, as a bitmap indexed by `way * set_count + row`.
+     * The bitmap is cleared by the call. The visualization consumes changes in batches this way
+     * instead of reacting to each access.
+     */
+    std::vector<bool> take_changed_lines() const;
+    /** Content of a line (only for enabled cache). */
+    const CacheLine &get_line(size_t way, size_t row) const;
+    const AccessRecord &get_last_access() const;
+
 signals:
     void hit_update(uint32_t) const;
     void miss_update(uint32_t) const;
@@ -98,15 +139,8 @@ signals:
         uint32_t stalled_cycles,
         double speed_improv,
         double hit_rate) const;
-    void cache_update(
-        size_t way,
-        size_t row,
-        size_t col,
-        bool valid,
-        bool dirty,
-        size_t tag,
-        const uint32_t *data,
-        bool write) const;
+    /** Emitted on the first change of a line after `take_changed_lines`. */
+    void lines_changed() const;
     void memory_writes_update(uint32_t) const;
     void memory_reads_update(uint32_t) const;
 
@@ -124,7 +158,16 @@ private:
     mutable uint32_t hit_read = 0, miss_read = 0, hit_write = 0, miss_write = 0,
                      mem_reads = 0, mem_writes = 0, burst_reads = 0,
                      burst_writes = 0, change_counter = 0;
+    /** Value of `mem_reads` last emitted by `report_direct_reads`. */
+    mutable uint32_t mem_reads_reported = 0;
+
+    mutable std::vector<bool> changed_lines;
+    mutable bool changes_pending = false;
+    mutable AccessRecord last_access;
 
+    void mark_line_changed(size_t way, size_t row) const;
+
+    /** Read without any effect on the cache, valid lines are read from the cache. */
     void internal_read(Address source, void *destination, size_t size) const;
 
     bool access(
@@ -133,6 +176,13 @@ private:
         size_t size,
         AccessType access_type) const;
 
+    /** Part of `access` within a single block. */
+    bool access_block(
+        const CacheLocation &loc,
+        byte *buffer,
+        size_t size,
+        AccessType access_type) const;
+
     void kick(size_t way, size_t row) const;
 
     Address calc_base_address(size_t tag, size_t row) const;
@@ -152,11 +202,17 @@ private:
 
     bool is_in_uncached_area(Address source) const;
 
+    /**
+     * Size of the initial part of an access, which lies either entirely inside or entirely
+     * outside of the uncached area.
+     */
+    size_t split_at_uncached_area(Address address, size_t size) const;
+
     /**
      * RW access to cache may span multiple blocks but it needs to be
      * performed per block.
      * This functions calculated the size, that will have to be performed by
-     * repeated access (recursive call of `access` method).
+     * repeated access (next iteration of the loop in `access` method).
      */
     size_t calculate_overflow_to_next_blocks(
         size_t access_size,
@@ -9,6 +9,7 @@
 
 #include <tests/utils/integer_decomposition.h>
 
+#include <algorithm>
 #include <cinttypes>
 
 using namespace machine;
@@ -249,4 +250,176 @@ void TestCache::cache_correctness() {
     }
 }
 
+void TestCache::cache_changed_lines() {
+    CacheConfig cache_c;
+    cache_c.set_write_policy(CacheConfig::WP_BACK);
+    cache_c.set_enabled(true);
+    cache_c.set_set_count(4);
+    cache_c.set_block_size(2);
+    cache_c.set_associativity(2);
+
+    Memory m(BIG);
+    TrivialBus m_frontend(&m);
+    Cache cache(&m_frontend, &cache_c);
+    unsigned notifications = 0;
+    QObject::connect(&cache, &Cache::lines_changed, [&]() { notifications++; });
+
+    // Row 1, repeated accesses are reported once.
+    cache.write_u32(0x208_addr, 0x24);
+    cache.write_u32(0x20c_addr, 0x25);
+    QCOMPARE(notifications, 1U);
+    QVERIFY(cache.get_last_access().valid);
+    QVERIFY(cache.get_last_access().write);
+    QCOMPARE(cache.get_last_access().row, size_t(1));
+    QCOMPARE(cache.get_last_access().col, size_t(1));
+    const size_t way = cache.get_last_access().way;
+
+    std::vector<bool> changed = cache.take_changed_lines();
+    QCOMPARE(changed.size(), size_t(8));
+    for (size_t i = 0; i < changed.size(); i++) {
+        QCOMPARE(bool(changed[i]), i == way * 4 + 1);
+    }
+    QVERIFY(cache.get_line(way, 1).valid);
+    QVERIFY(cache.get_line(way, 1).dirty);
+
+    // Nothing changed since the last take.
+    changed = cache.take_changed_lines();
+    QVERIFY(std::none_of(changed.begin(), changed.end(), [](bool c) { return c; }));
+
+    cache.flush();
+    QCOMPARE(notifications, 2U);
+    QVERIFY(!cache.get_last_access().valid);
+    changed = cache.take_changed_lines();
+    QVERIFY(changed[way * 4 + 1]);
+    QVERIFY(!cache.get_line(way, 1).valid);
+    QCOMPARE(memory_read_u32(&m, 0x20c), (uint32_t)0x25);
+}
+
+/**
+ * Block transfers span many cache lines and may cross the uncached area.
+ */
+void TestCache::cache_block() {
+    CacheConfig cache_c;
+    cache_c.set_write_policy(CacheConfig::WP_BACK);
+    cache_c.set_enabled(true);
+    cache_c.set_set_count(4);
+    cache_c.set_block_size(4);
+    cache_c.set_associativity(2);
+
+    Memory mem(LITTLE);
+    MemoryDataBus bus(LITTLE);
+    bus.insert_device_to_range(&mem, 0_addr, 0xffffffff_addr, false);
+    Cache cache(&bus, &cache_c);
+
+    // Block much larger than the cache, performed line by line.
+    const size_t size = 1 << 20;
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = uint8_t(i * 13 + (i >> 8));
+    }
+    QVERIFY(cache.write_block(0x10002_addr, data.data(), size));
+    std::vector<uint8_t> readback(size);
+    cache.read_block(readback.data(), 0x10002_addr, size);
+    QCOMPARE(readback, data);
+
+    // The part inside the uncached area goes directly to memory.
+    const Address base = 0xefffff00_addr;
+    const size_t cross_size = 0x200;
+    QVERIFY(cache.write_block(base, data.data(), cross_size));
+    QCOMPARE(memory_read_u8(&mem, 0xf0000010), data[0x110]);
+    QCOMPARE(memory_read_u8(&mem, 0xefffffff), uint8_t(0));
+    QVERIFY(cache.location_status(0xefffffff_addr) & LOCSTAT_CACHED);
+    QVERIFY(!(cache.location_status(0xf0000000_addr) & LOCSTAT_CACHED));
+    readback.assign(cross_size, 0);
+    cache.read_block(readback.data(), base, cross_size);
+    QVERIFY(std::equal(readback.begin(), readback.end(), data.begin()));
+
+    cache.flush();
+    QCOMPARE(memory_read_u8(&mem, 0xefffffff), data[0xff]);
+}
+
+/**
+ * Discarded lines are dropped without a write back, lines at the ends of the range are kept.
+ */
+void TestCache::cache_discard() {
+    CacheConfig cache_c;
+    cache_c.set_write_policy(CacheConfig::WP_BACK);
+    cache_c.set_enabled(true);
+    cache_c.set_set_count(4);
+    cache_c.set_block_size(4);
+    cache_c.set_associativity(2);
+
+    Memory mem(LITTLE);
+    MemoryDataBus bus(LITTLE);
+    bus.insert_device_to_range(&mem, 0_addr, 0xffffffff_addr, false);
+    Cache cache(&bus, &cache_c);
+
+    // Lines of 16 bytes, all of them stay dirty in the cache.
+    const Address base = 0x10000_addr;
+    std::vector<uint8_t> data(64);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = uint8_t(i + 1);
+    }
+    cache.write_block(base, data.data(), data.size());
+    const uint32_t writes = cache.get_write_count();
+
+    cache.discard(base + 8, 48, {});
+    // Only the two lines overlapping the ends of the range are written back.
+    QCOMPARE(cache.get_write_count(), writes + 2 * cache_c.block_size());
+    QVERIFY(mem.get_section(0x10000, false) != nullptr);
+    QVERIFY(!(cache.location_status(base + 16) & LOCSTAT_CACHED));
+    std::vector<uint8_t> readback(data.size());
+    cache.read_block(readback.data(), base, readback.size(), ae::INTERNAL);
+    for (size_t i = 0; i < data.size(); i++) {
+        QCOMPARE(readback[i], (i >= 8 && i < 56) ? uint8_t(0) : data[i]);
+    }
+
+    // Released memory is not written by a later flush.
+    cache.write_u32(0x20000_addr, 0x12345678);
+    cache.discard(0x20000_addr, 0x1000, {});
+    cache.flush();
+    QVERIFY(mem.get_section(0x20000, false) == nullptr);
+    QCOMPARE(cache.read_u32(0x20000_addr), uint32_t(0));
+}
+
+/**
+ * Internal block read takes dirty lines from the cache and the rest from the memory.
+ */
+void TestCache::cache_internal_read() {
+    CacheConfig cache_c;
+    cache_c.set_write_policy(CacheConfig::WP_BACK);
+    cache_c.set_enabled(true);
+    cache_c.set_set_count(4);
+    cache_c.set_block_size(4);
+    cache_c.set_associativity(2);
+
+    Memory mem(LITTLE);
+    MemoryDataBus bus(LITTLE);
+    bus.insert_device_to_range(&mem, 0_addr, 0xffffffff_addr, false);
+    Cache cache(&bus, &cache_c);
+
+    const Address base = 0x1000_addr;
+    std::vector<uint8_t> data(0x100);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = uint8_t(i * 11 + 1);
+    }
+    bus.write_block(base, data.data(), data.size());
+    // Dirty lines in the middle of the block, the first word is not cached.
+    const uint8_t dirty[] = { 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6 };
+    cache.write_block(base + 0x24, dirty, 4);
+    cache.write_block(base + 0x4e, dirty, 6);
+    std::copy(dirty, dirty + 4, data.begin() + 0x24);
+    std::copy(dirty, dirty + 6, data.begin() + 0x4e);
+    // Memory still holds the old content.
+    QCOMPARE(memory_read_u8(&mem, 0x1024), uint8_t(0x24 * 11 + 1));
+    const uint32_t hits = cache.get_hit_count();
+    const uint32_t misses = cache.get_miss_count();
+
+    std::vector<uint8_t> readback(data.size());
+    cache.read_block(readback.data(), base + 1, readback.size() - 1, ae::INTERNAL);
+    QVERIFY(std::equal(readback.begin(), readback.end() - 1, data.begin() + 1));
+    QCOMPARE(cache.get_hit_count(), hits);
+    QCOMPARE(cache.get_miss_count(), misses);
+}
+
 QTEST_APPLESS_MAIN(TestCache)
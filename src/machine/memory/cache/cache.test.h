@@ -10,6 +10,10 @@ private slots:
     static void cache();
     static void cache_correctness_data();
     static void cache_correctness();
+    static void cache_changed_lines();
+    static void cache_block();
+    static void cache_discard();
+    static void cache_internal_read();
 };
 
 #endif // CACHE_TEST_H
@@ -2,6 +2,8 @@
 
 #include "common/endian.h"
 
+#include <algorithm>
+
 namespace machine {
 
 bool FrontendMemory::write_u8(
@@ -48,6 +50,64 @@ uint64_t FrontendMemory::read_u64(Address address, AccessEffects type) const {
     return read_generic<uint64_t>(address, type);
 }
 
+std::vector<MemorySpan> FrontendMemory::get_spans(Address address, size_t size) const {
+    std::vector<MemorySpan> spans;
+    while (size > 0) {
+        const HostPage page = lookup_host_page(address);
+        const uint64_t offset = address.get_raw() - page.start;
+        size_t span_size = size;
+        const byte *data = nullptr;
+        if (offset < page.size) {
+            span_size = std::min<uint64_t>(size, page.size - offset);
+            if (page.data != nullptr) { data = page.data + offset; }
+        }
+        if (data == nullptr && !spans.empty() && spans.back().data == nullptr) {
+            spans.back().size += span_size;
+        } else {
+            spans.push_back({ .address = address,
+                              .size = span_size,
+                              .data = data,
+                              .read_counters = page.read_counters });
+        }
+        address += span_size;
+        size -= span_size;
+    }
+    return spans;
+}
+
+void FrontendMemory::read_block(
+    void *destination,
+    Address source,
+    size_t size,
+    AccessEffects type) const {
+    auto *dst = static_cast<byte *>(destination);
+    for (const MemorySpan &span : get_spans(source, size)) {
+        if (span.data != nullptr) {
+            memcpy(dst, span.data, span.size);
+            for (uint32_t *counter : span.read_counters) {
+                if (counter != nullptr) { (*counter)++; }
+            }
+        } else {
+            read(dst, span.address, span.size, { .type = type });
+        }
+        dst += span.size;
+    }
+}
+
+bool FrontendMemory::write_block(
+    Address destination,
+    const void *source,
+    size_t size,
+    AccessEffects type) {
+    bool changed = false;
+    const auto *src = static_cast<const byte *>(source);
+    for (const MemorySpan &span : get_spans(destination, size)) {
+        changed |= write(span.address, src, span.size, { .type = type }).changed;
+        src += span.size;
+    }
+    return changed;
+}
+
 void FrontendMemory::write_ctl(
     enum AccessControl ctl,
     Address offset,
@@ -111,10 +171,34 @@ LocationStatus FrontendMemory::location_status(Address address) const {
     return LOCSTAT_NONE;
 }
 
+HostPage FrontendMemory::lookup_host_page(Address address) const {
+    (void)address;
+    return { .start = 0, .size = UINT64_MAX };
+}
+
 template<typename T>
 T FrontendMemory::read_generic(Address address, AccessEffects type) const {
     T value;
-    read(&value, address, sizeof(T), { .type = type });
+    const uint64_t addr = address.get_raw();
+    if (addr - host_page.start >= host_page.size
+        || (host_page.generation_source != nullptr
+            && host_page.generation_source->get() != host_page.generation)) {
+        host_page = lookup_host_page(address);
+        if (host_page.generation_source != nullptr) {
+            host_page.generation = host_page.generation_source->get();
+        }
+    }
+    // Misaligned accesses and accesses crossing the page end take the regular
+    // path, which splits them between sections and devices.
+    if (host_page.data != nullptr && (addr & (sizeof(T) - 1)) == 0
+        && host_page.size >= sizeof(T) && addr - host_page.start <= host_page.size - sizeof(T)) {
+        memcpy(&value, host_page.data + (addr - host_page.start), sizeof(T));
+        for (uint32_t *counter : host_page.read_counters) {
+            if (counter != nullptr) { (*counter)++; }
+        }
+    } else {
+        read(&value, address, sizeof(T), { .type = type });
+    }
     // When cross-simulating (BIG simulator on LITTLE host machine and vice
     // versa) data needs to be swapped before writing to memory and after
     // reading from memory to achieve correct results of misaligned reads. See
@@ -9,13 +9,32 @@
 #include "simulator_exception.h"
 
 #include <QObject>
+#include <array>
 #include <cstdint>
+#include <vector>
 
 // Shortcut for enum class values, type is obvious from context.
 using ae = machine::AccessEffects;
 
 namespace machine {
 
+/**
+ * Contiguous part of a block transfer.
+ *
+ * Parts held in host memory of allocated memory sections are described by `data` and copied
+ * directly. The others (devices, unmapped addresses, unallocated sections, enabled caches) have
+ * null `data` and go through the regular `read`/`write` of the hierarchy.
+ *
+ * @see FrontendMemory::get_spans
+ */
+struct MemorySpan {
+    Address address;
+    size_t size;
+    const byte *data;
+    /** Statistics counters of the bypassed layers, @see HostPage. */
+    std::array<uint32_t *, 2> read_counters;
+};
+
 /**
  * # What is frontend memory
  *
@@ -65,6 +84,43 @@ public:
     [[nodiscard]] uint32_t read_u32(Address address, AccessEffects type = ae::REGULAR) const;
     [[nodiscard]] uint64_t read_u64(Address address, AccessEffects type = ae::REGULAR) const;
 
+    /**
+     * Split a block into spans (scatter/gather list of the block).
+     *
+     * Spans are bounded by memory sections and device ranges, neighbouring spans
+     * which have to go through the hierarchy are merged.
+     */
+    [[nodiscard]] std::vector<MemorySpan> get_spans(Address address, size_t size) const;
+
+    /**
+     * Copy a block of bytes from the emulated memory to a host buffer.
+     *
+     * Spans in host memory are copied directly, the rest is passed down the
+     * memory hierarchy as one request per span. It is split further only where
+     * the hierarchy requires it (cache lines, device ranges), so it is much
+     * cheaper than a loop of `read_u8`. Data are copied in memory order, no
+     * endian conversion is applied.
+     *
+     * @see get_spans
+     */
+    void read_block(void *destination, Address source, size_t size, AccessEffects type = ae::REGULAR)
+        const;
+
+    /**
+     * Copy a block of bytes from a host buffer to the emulated memory.
+     *
+     * Every span is written through the hierarchy, so changes are tracked and
+     * sections are allocated as needed.
+     *
+     * @see read_block
+     * @return              true when memory before and after write differs
+     */
+    bool write_block(
+        Address destination,
+        const void *source,
+        size_t size,
+        AccessEffects type = ae::REGULAR);
+
     /**
      * Store with size specified by the CPU control unit.
      *
@@ -88,6 +144,18 @@ public:
 
     virtual void sync();
     [[nodiscard]] virtual LocationStatus location_status(Address address) const;
+
+    /**
+     * Find host memory holding the content at given address.
+     *
+     * Used by `read_u8` ... `read_u64` to perform aligned reads with a single
+     * host load, bypassing the memory hierarchy. A frontend may only pass the
+     * lookup down when it has no own state for the address (e.g. a disabled
+     * cache). Default: no direct access.
+     *
+     * @see HostPage
+     */
+    [[nodiscard]] virtual HostPage lookup_host_page(Address address) const;
     [[nodiscard]] virtual uint32_t get_change_counter() const = 0;
 
     /**
@@ -120,6 +188,21 @@ public:
         size_t size,
         ReadOptions options) const = 0;
 
+    /**
+     * Drop content of a range, it reads as zero (or as given by `source`)
+     * afterwards.
+     *
+     * Unlike a write of zeros, cached copies of the range are dropped without
+     * a write back and the backing storage may be released. Used to unmap or
+     * remap memory of the emulated program.
+     *
+     * @param start         emulated address of the first discarded byte
+     * @param size          number of bytes to discard
+     * @param source        lazy content of the range, it is requested only
+     *                      for the parts which are touched later
+     */
+    virtual void discard(Address start, size_t size, const ContentSource &source = {}) = 0;
+
     /**
      * Endian of the simulated CPU/memory system.
      *
@@ -157,6 +240,11 @@ private:
     template<typename T>
     T read_generic(Address address, AccessEffects type) const;
 
+    /**
+     * Last page returned by `lookup_host_page`, revalidated by its generation.
+     */
+    mutable HostPage host_page;
+
     /**
      * Write to any type from memory
      *
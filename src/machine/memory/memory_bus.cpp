@@ -3,6 +3,8 @@
 #include "common/endian.h"
 #include "memory/memory_utils.h"
 
+#include <algorithm>
+
 using namespace machine;
 
 MemoryDataBus::MemoryDataBus(Endian simulated_endian)
@@ -41,9 +43,11 @@ WriteResult MemoryDataBus::write_single(
     if (range == nullptr) {
         // Write to unused address range - no devices it present.
         // This could produce a fault but for simplicity, we will
-        // just ignore the write.
-        return (WriteResult) { .n_bytes = 0, .changed = false };
+        // just ignore the write (up to the next range).
+        return (WriteResult) { .n_bytes = unmapped_size(destination, size), .changed = false };
     }
+    // The rest of the access continues in the following range.
+    size = std::min<uint64_t>(size, uint64_t(range->last_addr - destination) + 1);
     WriteResult result = range->device->write(
         destination - range->start_addr, source, size, options);
 
@@ -75,14 +79,43 @@ ReadResult MemoryDataBus::read_single(
         // Write to unused address range, no devices it present.
         // This could produce a fault but for simplicity, we will
         // consider unused ranges to be constantly zero.
+        size = unmapped_size(source, size);
         memset(destination, 0, size);
         return (ReadResult) { .n_bytes = size };
     }
+    // The rest of the access continues in the following range.
+    size = std::min<uint64_t>(size, uint64_t(p_range->last_addr - source) + 1);
 
     return p_range->device->read(
         destination, source - p_range->start_addr, size, options);
 }
 
+void MemoryDataBus::discard(Address start, size_t size, const ContentSource &source) {
+    if (size == 0) { return; }
+    const Address last = start + (size - 1);
+    for (auto iter = ranges_by_addr.lowerBound(start);
+         iter != ranges_by_addr.end() && iter.value()->start_addr <= last; iter++) {
+        const RangeDesc *range = iter.value();
+        const Address part_start = std::max(start, range->start_addr);
+        const Address part_last = std::min(last, range->last_addr);
+        // Source is relative to the start of the whole discarded range.
+        const uint64_t shift = part_start - start;
+        ContentSource part_source;
+        if (source && shift == 0) {
+            part_source = source;
+        } else if (source) {
+            part_source = [source, shift](uint64_t range_offset, byte *destination, size_t s) {
+                source(range_offset + shift, destination, s);
+            };
+        }
+        range->device->discard(
+            part_start - range->start_addr, part_last - part_start + 1, part_source);
+        change_counter++;
+        // Content changed without any write access, views have to be told.
+        emit external_change_notify(this, part_start, part_last, ae::INTERNAL);
+    }
+}
+
 uint32_t MemoryDataBus::get_change_counter() const {
     return change_counter;
 }
@@ -95,6 +128,25 @@ enum LocationStatus MemoryDataBus::location_status(Address address) const {
     return range->device->location_status(address - range->start_addr);
 }
 
+HostPage MemoryDataBus::lookup_host_page(Address address) const {
+    const RangeDesc *range = find_range(address);
+    if (range == nullptr) {
+        // Unused addresses read as zero, which requires the regular path.
+        return { .start = address.get_raw(),
+                 .size = unmapped_size(address, UINT64_MAX),
+                 .generation_source = host_page_generation.get() };
+    }
+    const Offset offset = address - range->start_addr;
+    const uint64_t range_last_offset = range->last_addr - range->start_addr;
+    HostPage page = range->device->lookup_host_page(offset);
+    // Clip the page to the range (the page contains offset, which is in range).
+    const uint64_t page_last = page.start + std::min(page.size - 1, range_last_offset - page.start);
+    page.size = page_last - page.start + 1;
+    page.start += range->start_addr.get_raw();
+    page.generation_source = host_page_generation.get();
+    return page;
+}
+
 const MemoryDataBus::RangeDesc *
 MemoryDataBus::find_range(Address address) const {
     // lowerBound finds range what has highest key (which is range->last_addr)
@@ -113,6 +165,15 @@ MemoryDataBus::find_range(Address address) const {
     return nullptr;
 }
 
+size_t MemoryDataBus::unmapped_size(Address address, size_t size) const {
+    // First range ending at or after the address, it starts after the address.
+    auto iter = ranges_by_addr.lowerBound(address);
+    if (iter == ranges_by_addr.end()) {
+        return size;
+    }
+    return std::min<uint64_t>(size, uint64_t(iter.value()->start_addr - address));
+}
+
 bool MemoryDataBus::insert_device_to_range(
     BackendMemory *device,
     Address start_addr,
@@ -137,6 +198,8 @@ bool MemoryDataBus::insert_device_to_range(
     // searched address for case that range is not present.
     ranges_by_addr.insert(last_addr, range);
     ranges_by_device.insert(device, range);
+    device->attach_host_page_generation(host_page_generation);
+    host_page_generation->bump();
     connect(
         device, &BackendMemory::external_backend_change_notify, this,
         &MemoryDataBus::range_backend_external_change);
@@ -150,6 +213,10 @@ bool MemoryDataBus::remove_device(BackendMemory *device) {
     }
 
     ranges_by_addr.remove(range->last_addr);
+    host_page_generation->bump();
+    if (!ranges_by_device.contains(device)) {
+        device->detach_host_page_generation(host_page_generation.get());
+    }
     if (range->owns_device) {
         delete range->device;
     }
@@ -208,7 +275,9 @@ bool MemoryDataBus::RangeDesc::overlaps(Address start, Address last) const {
 
 TrivialBus::TrivialBus(BackendMemory *backend_memory)
     : FrontendMemory(backend_memory->simulated_machine_endian)
-    , device(backend_memory) {}
+    , device(backend_memory) {
+    device->attach_host_page_generation(host_page_generation);
+}
 
 WriteResult TrivialBus::write(
     Address destination,
@@ -227,6 +296,18 @@ ReadResult TrivialBus::read(
     return device->read(destination, source.get_raw(), size, options);
 }
 
+void TrivialBus::discard(Address start, size_t size, const ContentSource &source) {
+    change_counter += 1;
+    device->discard(start.get_raw(), size, source);
+    if (size > 0) { emit external_change_notify(this, start, start + (size - 1), ae::INTERNAL); }
+}
+
 uint32_t TrivialBus::get_change_counter() const {
     return change_counter;
 }
+
+HostPage TrivialBus::lookup_host_page(Address address) const {
+    HostPage page = device->lookup_host_page(address.get_raw());
+    page.generation_source = host_page_generation.get();
+    return page;
+}
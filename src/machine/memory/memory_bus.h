@@ -11,6 +11,7 @@
 #include <QMultiMap>
 #include <QObject>
 #include <cstdint>
+#include <memory>
 
 namespace machine {
 
@@ -65,6 +66,12 @@ public:
         size_t size,
         ReadOptions options) const override;
 
+    /**
+     * Discard is passed to all devices in the range, unused addresses are
+     * skipped.
+     */
+    void discard(Address start, size_t size, const ContentSource &source) override;
+
     /**
      * Number of writes and external changes recorded.
      */
@@ -111,6 +118,12 @@ public:
 
     enum LocationStatus location_status(Address address) const override;
 
+    /**
+     * Pages of devices are translated to addresses and clipped to the range
+     * the device is mapped to.
+     */
+    HostPage lookup_host_page(Address address) const override;
+
 private slots:
     /**
      * Receive external changes in underlying memory devices.
@@ -130,12 +143,15 @@ private:
      */
     QMap<Address, const RangeDesc *> ranges_by_addr;
     mutable uint32_t change_counter = 0;
+    /** Shared with the connected devices, which may outlive the bus. */
+    const std::shared_ptr<HostPageGeneration> host_page_generation
+        = std::make_shared<HostPageGeneration>();
 
     /**
      * Helper to write into single range. Used by `write`.
      *
-     * Write spanning multiple ranges will succeed partially and return size,
-     * that was written.
+     * Write spanning multiple ranges is clipped to the range (or the gap between
+     * ranges) it starts in and returns size, that was written.
      * API corresponds to `BackendMemory` interface method `write`.
      */
     WriteResult write_single(
@@ -148,8 +164,8 @@ private:
      * Helper to read from single range. Used by `read` from Backend memory
      * interface.
      *
-     * Read spanning multiple ranges will succeed partially and return
-     * size, that was written.
+     * Read spanning multiple ranges is clipped to the range (or the gap between
+     * ranges) it starts in and returns size, that was read.
      * API corresponds to `BackendMemory` interface method `read`.
      */
     ReadResult read_single(
@@ -162,6 +178,11 @@ private:
      * Get range (or nullptr) for arbitrary address (not just start or last).
      */
     const MemoryDataBus::RangeDesc *find_range(Address address) const;
+
+    /**
+     * Number of bytes from an unmapped address to the start of the next range, at most size.
+     */
+    size_t unmapped_size(Address address, size_t size) const;
 };
 
 /**
@@ -216,11 +237,17 @@ public:
         size_t size,
         ReadOptions options) const override;
 
+    void discard(Address start, size_t size, const ContentSource &source) override;
+
     uint32_t get_change_counter() const override;
 
+    HostPage lookup_host_page(Address address) const override;
+
 private:
     BackendMemory *const device;
     mutable uint32_t change_counter = 0;
+    const std::shared_ptr<HostPageGeneration> host_page_generation
+        = std::make_shared<HostPageGeneration>();
 };
 
 } // namespace machine
@@ -4,6 +4,8 @@
 #include "common/endian.h"
 #include "utils.h"
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -89,6 +91,60 @@ struct WriteResult {
     }
 };
 
+/**
+ * Generation of the host pages handed out by one memory hierarchy (a bus and
+ * the devices connected to it).
+ *
+ * Bumped whenever a host page of the hierarchy may move or disappear (memory
+ * reset, section allocation or release, bus remap). Changes in one simulated
+ * machine do not invalidate host pages cached for the others.
+ */
+class HostPageGeneration {
+public:
+    [[nodiscard]] uint32_t get() const { return value.load(std::memory_order_relaxed); }
+    void bump() { value.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> value { 0 };
+};
+
+/**
+ * Host memory backing a range of the simulated address space.
+ *
+ * Used by the direct read path of the typed frontend accessors (`read_u32`
+ * etc.). Frontend memories describe the range in addresses, backend memories
+ * in offsets. When `data` is null, the range cannot be accessed directly and
+ * the regular `read` has to be used; such a page is cached too, so the lookup
+ * is not repeated for every access to a periphery.
+ *
+ * A page is valid only as long as the generation of the hierarchy it comes
+ * from (`generation_source`) equals `generation`. Page without a source does
+ * not change.
+ */
+struct HostPage {
+    uint64_t start = 0;
+    /** Size in bytes, zero marks an empty (never matching) page. */
+    uint64_t size = 0;
+    const byte *data = nullptr;
+    /**
+     * Statistics counters of the bypassed layers (disabled caches), which
+     * have to be incremented on each direct access.
+     */
+    std::array<uint32_t *, 2> read_counters {};
+    const HostPageGeneration *generation_source = nullptr;
+    uint32_t generation = 0;
+};
+
+/**
+ * Content of a discarded range, which is produced only when the range is touched.
+ *
+ * Called with an offset relative to the start of the discarded range. It fills up to `size` bytes
+ * of the zeroed `destination`, bytes it does not fill read as zero.
+ *
+ * @see FrontendMemory::discard
+ */
+using ContentSource = std::function<void(uint64_t range_offset, byte *destination, size_t size)>;
+
 /**
  * Perform n-byte read into periphery that only supports u32 access.
  *
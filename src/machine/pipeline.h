@@ -89,6 +89,7 @@ struct DecodeInterstage {
                                      // rd according to regd)
     RegisterValue csr_read_val = 0;  // Value read from csr
     CSR::Address csr_address = CSR::Address(0);
+    size_t csr_id = 0; // Internal id of the CSR at csr_address
     ExceptionCause excause = EXCAUSE_NONE;
     ForwardFrom ff_rs = FORWARD_NONE;
     ForwardFrom ff_rt = FORWARD_NONE;
@@ -117,6 +118,7 @@ struct DecodeInterstage {
     bool csr_to_alu = false;
     bool csr_write = false;
     bool xret = false;        // Return from exception, MRET and SRET
+    bool wfi = false;         // Wait for interrupt
     bool insert_stall_before = false;
 
 public:
@@ -164,6 +166,7 @@ struct ExecuteInterstage {
     RegisterValue immediate_val = 0;
     RegisterValue csr_read_val = 0;
     CSR::Address csr_address = CSR::Address(0);
+    size_t csr_id = 0; // Internal id of the CSR at csr_address
     ExceptionCause excause = EXCAUSE_NONE;
     AccessControl memctl = AC_NONE;
     RegisterId num_rd = 0;
@@ -179,6 +182,7 @@ struct ExecuteInterstage {
     bool csr = false;
     bool csr_write = false;
     bool xret = false;
+    bool wfi = false;
 
 public:
     /** Reset to value corresponding to NOP. */
@@ -4,6 +4,11 @@
 #include "common/logging.h"
 #include "simulator_exception.h"
 
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 #include <cerrno>
 #include <cstring>
 #include <exception>
@@ -121,28 +126,69 @@ ProgramLoader::~ProgramLoader() {
 }
 
 void ProgramLoader::to_memory(Memory *mem) {
-    // Load program to memory (just dump it byte by byte)
+    // Load program to memory, each segment is copied as a single block.
+    char *f = elf_rawfile(this->elf, nullptr);
     if (architecture_type == ARCH32) {
         for (size_t phdrs_i : this->indexes_of_load_sections) {
-            uint32_t base_address = this->sections_headers.arch32[phdrs_i].p_vaddr;
-            char *f = elf_rawfile(this->elf, nullptr);
-            for (unsigned y = 0; y < this->sections_headers.arch32[phdrs_i].p_filesz; y++) {
-                const auto buffer = (uint8_t)f[this->sections_headers.arch32[phdrs_i].p_offset + y];
-                memory_write_u8(mem, base_address + y, buffer);
-            }
+            const Elf32_Phdr &phdr = this->sections_headers.arch32[phdrs_i];
+            if (phdr.p_filesz == 0) { continue; }
+            mem->write(Offset(uint32_t(phdr.p_vaddr)), f + phdr.p_offset, phdr.p_filesz, {});
         }
     } else if (architecture_type == ARCH64) {
         for (size_t phdrs_i : this->indexes_of_load_sections) {
-            uint32_t base_address = this->sections_headers.arch64[phdrs_i].p_vaddr;
-            char *f = elf_rawfile(this->elf, nullptr);
-            for (unsigned y = 0; y < this->sections_headers.arch64[phdrs_i].p_filesz; y++) {
-                const auto buffer = (uint8_t)f[this->sections_headers.arch64[phdrs_i].p_offset + y];
-                memory_write_u8(mem, base_address + y, buffer);
-            }
+            const Elf64_Phdr &phdr = this->sections_headers.arch64[phdrs_i];
+            if (phdr.p_filesz == 0) { continue; }
+            mem->write(Offset(uint32_t(phdr.p_vaddr)), f + phdr.p_offset, phdr.p_filesz, {});
         }
     }
 }
 
+SymbolTable *ProgramImage::create_symbol_table() const {
+    auto *p_st = new SymbolTable();
+    for (const Symbol &sym : symbols) {
+        p_st->add_symbol(sym.name, sym.value, sym.size, sym.info, sym.other);
+    }
+    return p_st;
+}
+
+std::shared_ptr<const ProgramImage> ProgramLoader::load_cached(const QString &file) {
+    // Loaded images are few and cheap to keep compared to the time needed to parse them.
+    constexpr int CACHE_CAPACITY = 8;
+    struct CacheEntry {
+        QDateTime modified;
+        qint64 size;
+        std::shared_ptr<const ProgramImage> image;
+    };
+    static QMutex cache_mutex;
+    static QHash<QString, CacheEntry> cache;
+
+    QFileInfo info(file);
+    QString key = info.canonicalFilePath();
+    if (!key.isEmpty()) {
+        QMutexLocker locker(&cache_mutex);
+        auto cached = cache.constFind(key);
+        if (cached != cache.constEnd() && cached->modified == info.lastModified()
+            && cached->size == info.size()) {
+            return cached->image;
+        }
+    }
+
+    ProgramLoader program(file);
+    auto image = std::make_shared<ProgramImage>(program.get_endian());
+    image->architecture_type = program.get_architecture_type();
+    image->executable_entry = program.get_executable_entry();
+    image->end = program.end();
+    program.to_memory(&image->memory);
+    image->symbols = program.read_symbols();
+
+    if (!key.isEmpty()) {
+        QMutexLocker locker(&cache_mutex);
+        if (cache.size() >= CACHE_CAPACITY) { cache.clear(); }
+        cache.insert(key, { info.lastModified(), info.size(), image });
+    }
+    return image;
+}
+
 Address ProgramLoader::end() {
     uint32_t last = 0;
     // Go trough all sections and found out last one
@@ -168,6 +214,14 @@ Address ProgramLoader::get_executable_entry() const {
 
 SymbolTable *ProgramLoader::get_symbol_table() {
     auto *p_st = new SymbolTable();
+    for (const ProgramImage::Symbol &sym : read_symbols()) {
+        p_st->add_symbol(sym.name, sym.value, sym.size, sym.info, sym.other);
+    }
+    return p_st;
+}
+
+QVector<ProgramImage::Symbol> ProgramLoader::read_symbols() {
+    QVector<ProgramImage::Symbol> symbols;
     Elf_Scn *scn = nullptr;
     GElf_Shdr shdr;
     Elf_Data *data;
@@ -177,7 +231,7 @@ SymbolTable *ProgramLoader::get_symbol_table() {
 
     while (true) {
         if ((scn = elf_nextscn(this->elf, scn)) == nullptr) {
-            return p_st;
+            return symbols;
         }
         gelf_getshdr(scn, &shdr);
         if (shdr.sh_type == SHT_SYMTAB) {
@@ -190,15 +244,16 @@ SymbolTable *ProgramLoader::get_symbol_table() {
     count = shdr.sh_size / shdr.sh_entsize;
 
     /* retrieve the symbol names */
+    symbols.reserve(count);
     for (ii = 0; ii < count; ++ii) {
         GElf_Sym sym;
         gelf_getsym(data, ii, &sym);
-        p_st->add_symbol(
-            elf_strptr(elf, shdr.sh_link, sym.st_name), sym.st_value,
-            sym.st_size, sym.st_info, sym.st_other);
+        symbols.append(
+            { elf_strptr(elf, shdr.sh_link, sym.st_name), sym.st_value, SymbolSize(sym.st_size),
+              sym.st_info, sym.st_other });
     }
 
-    return p_st;
+    return symbols;
 }
 Endian ProgramLoader::get_endian() const {
     // Reading elf endian_id_byte according to the ELF specs.
@@ -8,6 +8,7 @@
 #include <QFile>
 #include <cstdint>
 #include <gelf.h>
+#include <memory>
 #include <qstring.h>
 #include <qvector.h>
 
@@ -18,8 +19,43 @@ enum ArchitectureType {
     ARCH64,
 };
 
+/**
+ * Executable already loaded to memory together with everything machine needs from the ELF file.
+ *
+ * Images are cached by ProgramLoader::load_cached and shared (read only) by all machines started
+ * from the same unmodified file.
+ */
+struct ProgramImage {
+    explicit ProgramImage(Endian endian) : endian(endian), memory(endian) {}
+
+    struct Symbol {
+        QString name;
+        SymbolValue value;
+        SymbolSize size;
+        SymbolInfo info;
+        SymbolOther other;
+    };
+
+    const Endian endian;
+    ArchitectureType architecture_type = ARCH32;
+    Address executable_entry;
+    Address end;
+    /** Content of all loadable segments. Machines start from a copy. */
+    Memory memory;
+    QVector<Symbol> symbols;
+
+    /** Create new symbol table (owned by the caller) from the cached symbols. */
+    SymbolTable *create_symbol_table() const;
+};
+
 class ProgramLoader {
 public:
+    /**
+     * Load executable or reuse image loaded before, when the file has not been modified since.
+     * Parsing errors are reported by exceptions as in the constructor.
+     */
+    static std::shared_ptr<const ProgramImage> load_cached(const QString &file);
+
     explicit ProgramLoader(const char *file);
     explicit ProgramLoader(const QString &file);
     ~ProgramLoader();
@@ -37,6 +73,8 @@ public:
     ArchitectureType get_architecture_type() const;
 
 private:
+    QVector<ProgramImage::Symbol> read_symbols();
+
     QFile elf_file;
     Elf *elf;
     GElf_Ehdr hdr {}; // elf file header
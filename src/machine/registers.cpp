@@ -45,6 +45,10 @@ RegisterValue Registers::read_gp(RegisterId reg) const {
     return value;
 }
 
+const std::array<RegisterValue, REGISTER_COUNT> &Registers::read_gp_all() const {
+    return this->gp;
+}
+
 void Registers::write_gp(RegisterId reg, RegisterValue value) {
     if (reg == 0) {
         return; // Skip write to $0
@@ -62,6 +62,8 @@ public:
                                                         // register
     void write_gp(RegisterId reg, RegisterValue value); // Write general-purpose
                                                         // register
+    // Read whole general-purpose register file without emitting read signals
+    const std::array<RegisterValue, REGISTER_COUNT> &read_gp_all() const;
 
     bool operator==(const Registers &c) const;
     bool operator!=(const Registers &c) const;
@@ -0,0 +1,126 @@
+#include "riscv_official.test.h"
+
+#include "machine/machine.h"
+#include "machine/machineconfig.h"
+
+#include <QDir>
+#include <QRunnable>
+#include <QThreadPool>
+#include <vector>
+
+using namespace machine;
+
+/** Value of a1 (x11) set by RVTEST_PASS, see `tests/riscv-official/env/p/riscv_test.h`. */
+constexpr uint64_t RVTEST_PASS_VALUE = 0x600d000;
+/** The longest test finishes in a small fraction of this. */
+constexpr unsigned RVTEST_CYCLE_LIMIT = 1000000;
+
+static QString elf_dir() {
+    QString dir = qEnvironmentVariable("RISCV_OFFICIAL_ELF_DIR");
+    return dir.isEmpty() ? QStringLiteral(RISCV_OFFICIAL_ELF_DIR) : dir;
+}
+
+/**
+ * Runs a single test ELF until it reports its result by ECALL.
+ *
+ * The outcome is stored to a slot owned by the caller, which is not touched until the thread pool
+ * is done, so no locking is needed.
+ */
+class RvTestTask final : public QRunnable {
+public:
+    RvTestTask(MachineConfig config, QString *failure) : config(std::move(config)), failure(failure) {}
+
+    void run() override {
+        Machine machine(config, false, true);
+        bool stopped = false;
+        QObject::connect(
+            machine.core(), &Core::stop_on_exception_reached, [&stopped]() { stopped = true; });
+        QObject::connect(&machine, &Machine::program_trap, [this](SimulatorException &e) {
+            *failure = e.msg(false);
+        });
+
+        unsigned cycles = 0;
+        while (!stopped && !machine.exited() && cycles++ < RVTEST_CYCLE_LIMIT) {
+            machine.step();
+        }
+        if (!failure->isEmpty()) { return; }
+        if (!stopped) {
+            *failure = machine.exited() ? QStringLiteral("program left without ECALL")
+                                        : QStringLiteral("cycle limit reached");
+            return;
+        }
+        uint64_t result = machine.registers()->read_gp(11).as_u64();
+        if (result != RVTEST_PASS_VALUE) {
+            *failure = QStringLiteral("FAIL, a1 = 0x%1").arg(result, 0, 16);
+        }
+    }
+
+private:
+    const MachineConfig config;
+    QString *const failure;
+};
+
+void TestRiscvOfficial::riscv_official_data() {
+    QTest::addColumn<bool>("pipelined");
+    QTest::addColumn<int>("hazard_unit");
+    QTest::addColumn<bool>("cache");
+
+    // Pipeline without hazard unit is not expected to execute arbitrary code correctly.
+    for (bool cache : { false, true }) {
+        QString suffix = cache ? " cached" : "";
+        QTest::addRow("single%s", qPrintable(suffix))
+            << false << int(MachineConfig::HU_STALL_FORWARD) << cache;
+        QTest::addRow("pipelined stall%s", qPrintable(suffix))
+            << true << int(MachineConfig::HU_STALL) << cache;
+        QTest::addRow("pipelined forward%s", qPrintable(suffix))
+            << true << int(MachineConfig::HU_STALL_FORWARD) << cache;
+    }
+}
+
+void TestRiscvOfficial::riscv_official() {
+    QFETCH(bool, pipelined);
+    QFETCH(int, hazard_unit);
+    QFETCH(bool, cache);
+
+    // Same selection as `qtrvsim_tester.py -M -A`, RV32 and RV64 variants are both included.
+    const QDir dir(elf_dir());
+    const QStringList tests = dir.entryList(
+        { "rv32ui-p-*", "rv64ui-p-*", "rv32um-p-*", "rv64um-p-*", "rv32ua-p-*", "rv64ua-p-*" },
+        QDir::Files, QDir::Name);
+    if (tests.isEmpty()) { QSKIP("Official RISC-V tests are not built, see tests/riscv-official."); }
+
+    MachineConfig config;
+    config.set_pipelined(pipelined);
+    config.set_hazard_unit(static_cast<MachineConfig::HazardUnit>(hazard_unit));
+    if (cache) {
+        // Same as `CACHE_SETTINGS` in `tests/riscv-official/code/constants.py`.
+        for (CacheConfig *cache_config : { config.access_cache_data(), config.access_cache_program() }) {
+            cache_config->set_enabled(true);
+            cache_config->set_replacement_policy(CacheConfig::RP_LRU);
+            cache_config->set_set_count(2);
+            cache_config->set_block_size(2);
+            cache_config->set_associativity(2);
+        }
+        config.access_cache_data()->set_write_policy(CacheConfig::WP_BACK);
+    }
+
+    std::vector<QString> failures(tests.size());
+    QThreadPool pool;
+    for (int i = 0; i < tests.size(); i++) {
+        MachineConfig test_config(config);
+        test_config.set_elf(dir.filePath(tests[i]));
+        pool.start(new RvTestTask(test_config, &failures[i]));
+    }
+    pool.waitForDone();
+
+    int failed = 0;
+    for (int i = 0; i < tests.size(); i++) {
+        if (!failures[i].isEmpty()) {
+            qWarning("%s: %s", qPrintable(tests[i]), qPrintable(failures[i]));
+            failed++;
+        }
+    }
+    QCOMPARE(failed, 0);
+}
+
+QTEST_GUILESS_MAIN(TestRiscvOfficial)
@@ -0,0 +1,21 @@
+#ifndef RISCV_OFFICIAL_TEST_H
+#define RISCV_OFFICIAL_TEST_H
+
+#include <QtTest>
+
+/**
+ * Runs the official RISC-V ISA tests (`tests/riscv-official`) in-process.
+ *
+ * All test ELF files are run concurrently, each on its own machine, for every core configuration
+ * the simulator is expected to pass them in. The test is skipped when the ELF files have not been
+ * built. Another directory can be selected by the `RISCV_OFFICIAL_ELF_DIR` environment variable.
+ */
+class TestRiscvOfficial : public QObject {
+    Q_OBJECT
+
+private slots:
+    static void riscv_official_data();
+    static void riscv_official();
+};
+
+#endif // RISCV_OFFICIAL_TEST_H
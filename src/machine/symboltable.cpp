@@ -1,5 +1,6 @@
 #include "symboltable.h"
 
+#include <algorithm>
 #include <utility>
 
 using namespace machine;
@@ -40,6 +41,7 @@ void SymbolTable::add_symbol(
     auto *p_entry = new SymbolTableEntry(name, value, size, info, other);
     map_value_to_symbol.insert(value, p_entry);
     map_name_to_symbol.insert(name, p_entry);
+    interval_index_valid = false;
 }
 
 void SymbolTable::remove_symbol(const QString &name) {
@@ -49,6 +51,7 @@ void SymbolTable::remove_symbol(const QString &name) {
     }
     map_value_to_symbol.remove(p_entry->value, p_entry);
     delete p_entry;
+    interval_index_valid = false;
 }
 
 void SymbolTable::set_symbol(
@@ -83,6 +86,65 @@ bool SymbolTable::location_to_name(QString &name, SymbolValue value) const {
     return true;
 }
 
+void SymbolTable::build_interval_index() const {
+    interval_index.clear();
+    interval_index.reserve(map_value_to_symbol.size());
+    // QMultiMap iterates in ascending order of values.
+    for (auto i = map_value_to_symbol.cbegin(); i != map_value_to_symbol.cend(); i++) {
+        const SymbolTableEntry *entry = i.value();
+        // Section and file symbols have no name.
+        if (entry->name.isEmpty()) { continue; }
+        if (entry->size == 0) {
+            auto next = map_value_to_symbol.upperBound(i.key());
+            if (next == map_value_to_symbol.cend()) { continue; }
+            interval_index.push_back({ entry->value, next.key(), entry });
+        } else {
+            interval_index.push_back({ entry->value, entry->value + entry->size, entry });
+        }
+    }
+    interval_last_hit = 0;
+    interval_index_valid = true;
+}
+
+const SymbolTableEntry *SymbolTable::find_containing(SymbolValue address) const {
+    if (!interval_index_valid) { build_interval_index(); }
+    const size_t count = interval_index.size();
+    if (count == 0) { return nullptr; }
+
+    // The last hit is valid only when it is the last interval starting at or before address.
+    size_t i = interval_last_hit;
+    if (!(i < count && interval_index[i].start <= address
+          && (i + 1 == count || interval_index[i + 1].start > address))) {
+        auto it = std::upper_bound(
+            interval_index.cbegin(), interval_index.cend(), address,
+            [](SymbolValue addr, const Interval &interval) { return addr < interval.start; });
+        if (it == interval_index.cbegin()) { return nullptr; }
+        i = (it - interval_index.cbegin()) - 1;
+        interval_last_hit = i;
+    }
+
+    // Nested ranges: look back for an enclosing one, the depth is small in practice.
+    constexpr size_t MAX_NESTING = 8;
+    for (size_t depth = 0; depth < MAX_NESTING; depth++, i--) {
+        if (address < interval_index[i].end) { return interval_index[i].entry; }
+        if (i == 0) { break; }
+    }
+    return nullptr;
+}
+
+bool SymbolTable::location_to_symbol_offset(QString &text, SymbolValue address) const {
+    const SymbolTableEntry *entry = find_containing(address);
+    if (entry == nullptr) {
+        text = "";
+        return false;
+    }
+    text = entry->name;
+    if (address != entry->value) {
+        text += QString("+0x%1").arg(address - entry->value, 0, 16);
+    }
+    return true;
+}
+
 QStringList SymbolTable::names() const {
     return map_name_to_symbol.keys();
 }
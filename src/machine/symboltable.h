@@ -8,6 +8,7 @@
 #include <QObject>
 #include <QString>
 #include <QStringList>
+#include <vector>
 
 namespace machine {
 
@@ -69,7 +70,40 @@ public slots:
      */
     bool location_to_name(QString &name, SymbolValue value) const;
 
+public:
+    /**
+     * Find the symbol whose range contains given address (e.g. function containing PC).
+     *
+     * Symbols with nonzero size cover [value, value + size). Symbols without size (assembler
+     * labels) extend to the start of the next symbol. When ranges are nested, the one starting
+     * closest to the address wins.
+     *
+     * @return  the symbol or nullptr, when address is outside all symbols
+     */
+    const SymbolTableEntry *find_containing(SymbolValue address) const;
+
+    /**
+     * Describe address as symbol name and offset (`name+0x10`).
+     *
+     * @return  false when no symbol contains the address
+     */
+    bool location_to_symbol_offset(QString &text, SymbolValue address) const;
+
 private:
+    struct Interval {
+        SymbolValue start;
+        SymbolValue end;
+        const SymbolTableEntry *entry;
+    };
+
+    /** Rebuild of the interval index is deferred to the first lookup after modification. */
+    void build_interval_index() const;
+
+    mutable std::vector<Interval> interval_index;
+    mutable bool interval_index_valid = false;
+    /** Index of the interval returned by the last lookup. Lookups tend to repeat. */
+    mutable size_t interval_last_hit = 0;
+
     // QString cannot be made const, because it would not fit into QT gui API.
     QMap<QString, OWNED SymbolTableEntry *> map_name_to_symbol;
     QMultiMap<SymbolValue, SymbolTableEntry *> map_value_to_symbol;
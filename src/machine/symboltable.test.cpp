@@ -0,0 +1,47 @@
+#include "symboltable.test.h"
+
+#include "machine/symboltable.h"
+
+using namespace machine;
+
+void TestSymbolTable::symbol_table_containing() {
+    SymbolTable st;
+    st.add_symbol("_start", 0x200, 0);
+    st.add_symbol("loop", 0x210, 0);
+    st.add_symbol("func", 0x300, 0x40);
+    st.add_symbol("inner", 0x310, 0);
+    st.add_symbol("end", 0x400, 0);
+    st.add_symbol("data", 0x1000, 4);
+
+    QVERIFY(st.find_containing(0x1fc) == nullptr);
+    QCOMPARE(st.find_containing(0x200)->name, QString("_start"));
+    QCOMPARE(st.find_containing(0x20c)->name, QString("_start"));
+    QCOMPARE(st.find_containing(0x210)->name, QString("loop"));
+    // Label without size extends up to the next symbol.
+    QCOMPARE(st.find_containing(0x2fc)->name, QString("loop"));
+    QCOMPARE(st.find_containing(0x304)->name, QString("func"));
+    QCOMPARE(st.find_containing(0x314)->name, QString("inner"));
+    QCOMPARE(st.find_containing(0x400)->name, QString("end"));
+    QCOMPARE(st.find_containing(0x1002)->name, QString("data"));
+    QVERIFY(st.find_containing(0x1004) == nullptr);
+
+    QString text;
+    QVERIFY(st.location_to_symbol_offset(text, 0x304));
+    QCOMPARE(text, QString("func+0x4"));
+    QVERIFY(st.location_to_symbol_offset(text, 0x300));
+    QCOMPARE(text, QString("func"));
+    QVERIFY(!st.location_to_symbol_offset(text, 0x100));
+}
+
+void TestSymbolTable::symbol_table_containing_update() {
+    SymbolTable st;
+    st.add_symbol("a", 0x100, 0x10);
+    QCOMPARE(st.find_containing(0x108)->name, QString("a"));
+    st.add_symbol("b", 0x104, 0x8);
+    QCOMPARE(st.find_containing(0x108)->name, QString("b"));
+    QCOMPARE(st.find_containing(0x10c)->name, QString("a"));
+    st.remove_symbol("b");
+    QCOMPARE(st.find_containing(0x108)->name, QString("a"));
+}
+
+QTEST_APPLESS_MAIN(TestSymbolTable)
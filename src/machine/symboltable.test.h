@@ -0,0 +1,14 @@
+#ifndef SYMBOLTABLE_TEST_H
+#define SYMBOLTABLE_TEST_H
+
+#include <QtTest>
+
+class TestSymbolTable : public QObject {
+    Q_OBJECT
+
+private slots:
+    static void symbol_table_containing();
+    static void symbol_table_containing_update();
+};
+
+#endif // SYMBOLTABLE_TEST_H
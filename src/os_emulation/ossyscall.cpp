@@ -6,10 +6,13 @@
 #include "target_errno.h"
 #include "posix_polyfill.h"
 
+#include <QFile>
 #include <cerrno>
 #include <cinttypes>
 #include <cstdio>
+#include <cstring>
 #include <fcntl.h>
+#include <memory>
 #include <sys/stat.h>
 
 using namespace machine;
@@ -41,6 +44,13 @@ using namespace osemu;
 
 #define TARGET_AT_FDCWD -100
 
+#define TARGET_MAP_SHARED 0x01
+#define TARGET_MAP_PRIVATE 0x02
+#define TARGET_MAP_FIXED 0x10
+#define TARGET_MAP_ANONYMOUS 0x20
+
+#define TARGET_PAGE_SIZE 4096
+
 static const QMap<int, int> map_target_o_flags_to_o_flags = {
 #ifdef O_CREAT
     { TARGET_O_CREAT, O_CREAT },
@@ -542,6 +552,7 @@ OsSyscallExceptionHandler::OsSyscallExceptionHandler(
     bool unknown_syscall_stop,
     QString fs_root)
     : fd_mapping(3, FD_TERMINAL) {
+    brk_start = 0;
     brk_limit = 0;
     anonymous_base = 0x60000000;
     anonymous_last = anonymous_base;
@@ -631,10 +642,7 @@ int32_t OsSyscallExceptionHandler::write_mem(
     uint32_t count) {
     if ((uint32_t)data.size() < count) count = data.size();
 
-    for (uint32_t i = 0; i < count; i++) {
-        mem->write_u8(addr, data[i]);
-        addr += 1;
-    }
+    mem->write_block(addr, data.data(), count);
     return count;
 }
 
@@ -644,20 +652,39 @@ int32_t OsSyscallExceptionHandler::read_mem(
     QVector<uint8_t> &data,
     uint32_t count) {
     data.resize(count);
-    for (uint32_t i = 0; i < count; i++) {
-        data[i] = mem->read_u8(addr);
-        addr += 1;
-    }
+    mem->read_block(data.data(), addr, count);
     return count;
 }
 
+void OsSyscallExceptionHandler::unmap_range(FrontendMemory *mem, uint64_t start, uint64_t end) {
+    QVector<QPair<uint64_t, uint64_t>> affected;
+    for (auto i = mappings.cbegin(); i != mappings.cend() && i.key() < end; i++) {
+        if (i.value() > start) affected.append({ i.key(), i.value() });
+    }
+    for (const auto &mapping : affected) {
+        mappings.remove(mapping.first);
+        if (mapping.first < start) mappings.insert(mapping.first, start);
+        if (mapping.second > end) mappings.insert(end, mapping.second);
+        // Released pages read as zero when they are mapped again.
+        uint64_t discard_start = qMax(mapping.first, start);
+        mem->discard(Address(discard_start), qMin(mapping.second, end) - discard_start);
+    }
+    if (end >= anonymous_last) {
+        uint64_t top = anonymous_base;
+        for (auto i = mappings.cbegin(); i != mappings.cend(); i++) {
+            if (i.key() >= anonymous_base) top = qMax(top, i.value());
+        }
+        anonymous_last = top;
+    }
+}
+
 int32_t OsSyscallExceptionHandler::write_io(int fd, const QVector<uint8_t> &data, uint32_t count) {
     if ((uint32_t)data.size() < count) count = data.size();
     if (fd == FD_UNUSED) {
         return -1;
     } else if (fd == FD_TERMINAL) {
-        for (uint32_t i = 0; i < count; i++)
-            emit char_written(fd, data[i]);
+        emit chars_written(
+            fd, QByteArray(reinterpret_cast<const char *>(data.data()), static_cast<int>(count)));
     } else {
         count = write(fd, data.data(), count);
     }
@@ -1177,12 +1204,58 @@ int OsSyscallExceptionHandler::do_sys_brk(
 
     result = 0;
     uint32_t new_limit = a1;
+    // Invalid requests (including query by zero) keep and return the current break.
+    if (new_limit == 0 || new_limit < brk_start || new_limit >= anonymous_base) {
+        result = brk_limit;
+        return 0;
+    }
+    // The first request defines the start of the heap.
+    if (brk_start == 0) { brk_start = new_limit; }
+    // Growth needs no action, memory sections are allocated on the first write.
+    if (new_limit < brk_limit) {
+        core->get_mem_data()->discard(Address(new_limit), brk_limit - new_limit);
+    }
     brk_limit = new_limit;
     result = brk_limit;
 
     return 0;
 }
 
+namespace {
+
+/**
+ * File behind a file backed mapping. Its contents are mapped to the host memory when the mapping
+ * is touched for the first time.
+ */
+struct MappedFile {
+    QFile file;
+    qint64 offset = 0;
+    /** Number of bytes of the mapping backed by the file, the rest reads as zero. */
+    qint64 size = 0;
+    uchar *data = nullptr;
+
+    ~MappedFile() {
+        if (data != nullptr) { file.unmap(data); }
+    }
+
+    void read(uint64_t range_offset, byte *destination, size_t count) {
+        if (range_offset >= uint64_t(size)) { return; }
+        count = qMin<uint64_t>(count, size - range_offset);
+        if (data == nullptr) { data = file.map(offset, size, QFileDevice::MapPrivateOption); }
+        if (data != nullptr) {
+            memcpy(destination, data + range_offset, count);
+        } else {
+            // Keep the file position seen by the program unchanged.
+            qint64 pos = file.pos();
+            file.seek(offset + qint64(range_offset));
+            file.read(reinterpret_cast<char *>(destination), qint64(count));
+            file.seek(pos);
+        }
+    }
+};
+
+} // namespace
+
 // void *mmap(void *addr, size_t length, int prot,
 //             int flags, int fd, off_t pgoffset);
 int OsSyscallExceptionHandler::do_sys_mmap(
@@ -1203,24 +1276,99 @@ int OsSyscallExceptionHandler::do_sys_mmap(
     (void)a4;
     (void)a5;
     (void)a6;
-    // TODO: actually mmmap file, now that we can.
 
     result = 0;
     uint32_t addr = a1;
-    uint32_t lenght = a2;
-    uint32_t prot = a3;
+    uint64_t length = a2;
     uint32_t flags = a4;
-    uint32_t fd = a5;
+    int fd = a5;
     uint64_t offset = a6;
+    FrontendMemory *mem = core->get_mem_data();
 
-    printf(
-        "sys_mmap addr = 0x%08lx lenght= 0x%08lx prot = 0x%08lx flags = "
-        "0x%08lx fd = %d offset = 0x%08llx\n",
-        (unsigned long)addr, (unsigned long)lenght, (unsigned long)prot, (unsigned long)flags,
-        (int)fd, (unsigned long long)offset);
+    if (length == 0 || (offset % TARGET_PAGE_SIZE) != 0
+        || ((flags & TARGET_MAP_FIXED) && (addr % TARGET_PAGE_SIZE) != 0)
+        || !(flags & (TARGET_MAP_SHARED | TARGET_MAP_PRIVATE))) {
+        result = -TARGET_EINVAL;
+        return 0;
+    }
+    length = (length + TARGET_PAGE_SIZE - 1) & ~uint64_t(TARGET_PAGE_SIZE - 1);
+
+    // Shared mappings are served as private copies, stores are not written back to the file.
+    ContentSource source;
+    if (!(flags & TARGET_MAP_ANONYMOUS)) {
+        fd = targetfd_to_fd(fd);
+        if (fd == FD_TERMINAL) {
+            result = -TARGET_ENODEV;
+            return 0;
+        }
+        // The mapping outlives the descriptor, it keeps its own duplicate.
+        int mapped_fd = (fd == FD_INVALID) ? -1 : dup(fd);
+        auto file = std::make_shared<MappedFile>();
+        if (mapped_fd < 0
+            || !file->file.open(mapped_fd, QIODevice::ReadOnly, QFileDevice::AutoCloseHandle)) {
+            if (mapped_fd >= 0) { close(mapped_fd); }
+            result = -TARGET_EBADF;
+            return 0;
+        }
+        file->offset = offset;
+        file->size = qMax<qint64>(0, qMin<qint64>(length, file->file.size() - qint64(offset)));
+        source = [file](uint64_t range_offset, byte *destination, size_t size) {
+            file->read(range_offset, destination, size);
+        };
+    }
 
-    result = anonymous_last;
-    anonymous_last += lenght;
+    uint64_t start = (flags & TARGET_MAP_FIXED) ? addr : anonymous_last;
+    if (start + length > 0x100000000) {
+        result = -TARGET_ENOMEM;
+        return 0;
+    }
+    if (flags & TARGET_MAP_FIXED) {
+        unmap_range(mem, start, start + length);
+    }
+    mappings.insert(start, start + length);
+    if (start >= anonymous_base && start + length > anonymous_last) {
+        anonymous_last = start + length;
+    }
+
+    // Nothing is copied here. Memory sections are allocated on the first touch and file contents
+    // are read into them at that time.
+    mem->discard(Address(start), length, source);
+
+    result = start;
+
+    return 0;
+}
+
+// int munmap(void *addr, size_t length);
+int OsSyscallExceptionHandler::do_sys_munmap(
+    uint64_t &result,
+    Core *core,
+    uint64_t syscall_num,
+    uint64_t a1,
+    uint64_t a2,
+    uint64_t a3,
+    uint64_t a4,
+    uint64_t a5,
+    uint64_t a6) {
+    (void)core;
+    (void)syscall_num;
+    (void)a1;
+    (void)a2;
+    (void)a3;
+    (void)a4;
+    (void)a5;
+    (void)a6;
+
+    result = 0;
+    uint32_t addr = a1;
+    uint64_t length = a2;
+
+    if (length == 0 || (addr % TARGET_PAGE_SIZE) != 0) {
+        result = -TARGET_EINVAL;
+        return 0;
+    }
+    length = (length + TARGET_PAGE_SIZE - 1) & ~uint64_t(TARGET_PAGE_SIZE - 1);
+    unmap_range(core->get_mem_data(), addr, uint64_t(addr) + length);
 
     return 0;
 }
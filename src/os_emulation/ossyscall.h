@@ -9,6 +9,8 @@
 #include "machine/registers.h"
 #include "machine/simulator_exception.h"
 
+#include <QByteArray>
+#include <QMap>
 #include <QObject>
 #include <QString>
 #include <QVector>
@@ -47,6 +49,7 @@ public:
     OSSYCALL_HANDLER_DECLARE(do_sys_ftruncate);
     OSSYCALL_HANDLER_DECLARE(do_sys_brk);
     OSSYCALL_HANDLER_DECLARE(do_sys_mmap);
+    OSSYCALL_HANDLER_DECLARE(do_sys_munmap);
 
     OSSYCALL_HANDLER_DECLARE(do_spim_print_integer);
     OSSYCALL_HANDLER_DECLARE(do_spim_print_string);
@@ -57,7 +60,7 @@ public:
     OSSYCALL_HANDLER_DECLARE(do_spim_read_character);
 
 signals:
-    void char_written(int fd, unsigned int val);
+    void chars_written(int fd, const QByteArray &data);
     void rx_byte_pool(int fd, unsigned int &data, bool &available);
 
 private:
@@ -76,6 +79,8 @@ private:
         machine::Address addr,
         QVector<uint8_t> &data,
         uint32_t count);
+    /** Drop mappings (or their parts) inside [start, end) and discard their contents. */
+    void unmap_range(machine::FrontendMemory *mem, uint64_t start, uint64_t end);
     int32_t write_io(int fd, const QVector<uint8_t> &data, uint32_t count);
     int32_t read_io(int fd, QVector<uint8_t> &data, uint32_t count, bool add_nl_at_eof = false);
     int allocate_fd(int val = FD_UNUSED);
@@ -85,9 +90,12 @@ private:
     QString filepath_to_host(QString path);
 
     QVector<int> fd_mapping;
+    uint32_t brk_start;
     uint32_t brk_limit;
     uint32_t anonymous_base;
-    uint32_t anonymous_last;
+    uint64_t anonymous_last;
+    /** Mapped guest address ranges, start -> end (exclusive), page aligned. */
+    QMap<uint64_t, uint64_t> mappings;
     bool known_syscall_stop;
     bool unknown_syscall_stop;
     QString fs_root;
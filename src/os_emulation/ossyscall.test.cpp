@@ -0,0 +1,218 @@
+#include "ossyscall.test.h"
+
+#include "machine/core.h"
+#include "machine/csr/controlstate.h"
+#include "machine/machineconfig.h"
+#include "machine/memory/backend/memory.h"
+#include "machine/memory/cache/cache.h"
+#include "machine/memory/memory_bus.h"
+#include "machine/predictor.h"
+#include "machine/registers.h"
+#include "ossyscall.h"
+#include "target_errno.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+using namespace machine;
+using namespace osemu;
+
+constexpr uint64_t PAGE = 4096;
+constexpr uint64_t FLAG_MAP_PRIVATE = 0x02;
+constexpr uint64_t FLAG_MAP_FIXED = 0x10;
+constexpr uint64_t FLAG_MAP_ANONYMOUS = 0x20;
+constexpr uint64_t FLAGS_ANONYMOUS = FLAG_MAP_PRIVATE | FLAG_MAP_ANONYMOUS;
+
+static CacheConfig write_back_cache() {
+    CacheConfig config;
+    config.set_enabled(true);
+    config.set_write_policy(CacheConfig::WP_BACK);
+    config.set_set_count(8);
+    config.set_block_size(4);
+    config.set_associativity(2);
+    return config;
+}
+
+/**
+ * Core with memory behind a write back data cache, system calls are invoked directly.
+ */
+class OsemuMachine {
+public:
+    explicit OsemuMachine(const QString &fs_root = "")
+        : cache_config(write_back_cache())
+        , cache(&bus, &cache_config)
+        , core(&regs, &predictor, &cache, &cache, &control_state, Xlen::_32,
+               config_isa_word_default)
+        , osemu(false, false, fs_root) {
+        bus.insert_device_to_range(&memory, 0x00000000_addr, 0xefffffff_addr, false);
+    }
+
+    uint64_t
+    mmap(uint64_t addr, uint64_t length, uint64_t flags, int fd = -1, uint64_t offset = 0) {
+        uint64_t result = 0;
+        osemu.do_sys_mmap(result, &core, 0, addr, length, 3, flags, uint64_t(fd), offset);
+        return result;
+    }
+
+    uint64_t munmap(uint64_t addr, uint64_t length) {
+        uint64_t result = 0;
+        osemu.do_sys_munmap(result, &core, 0, addr, length, 0, 0, 0, 0);
+        return result;
+    }
+
+    uint64_t brk(uint64_t addr) {
+        uint64_t result = 0;
+        osemu.do_sys_brk(result, &core, 0, addr, 0, 0, 0, 0, 0);
+        return result;
+    }
+
+    int open(const QByteArray &path) {
+        const Address path_address = 0x1000_addr;
+        cache.write_block(path_address, path.constData(), path.size() + 1);
+        uint64_t result = 0;
+        osemu.do_sys_openat(result, &core, 0, uint64_t(-100), path_address.get_raw(), 0, 0, 0, 0);
+        return int(result);
+    }
+
+    void close(int fd) {
+        uint64_t result = 0;
+        osemu.do_sys_close(result, &core, 0, fd, 0, 0, 0, 0, 0);
+    }
+
+    bool allocated(uint64_t address) const {
+        return memory.get_section(address, false) != nullptr;
+    }
+
+    bool cached(uint64_t address) const {
+        return cache.location_status(Address(address)) & LOCSTAT_CACHED;
+    }
+
+    Memory memory { LITTLE };
+    MemoryDataBus bus { LITTLE };
+    CacheConfig cache_config;
+    Cache cache;
+    Registers regs;
+    FalsePredictor predictor;
+    CSR::ControlState control_state;
+    CoreSingle core;
+    OsSyscallExceptionHandler osemu;
+};
+
+void TestOsSyscall::ossyscall_mmap_anonymous() {
+    OsemuMachine m;
+    const uint64_t first = m.mmap(0, 3 * PAGE + 5, FLAGS_ANONYMOUS);
+    QCOMPARE(first, uint64_t(0x60000000));
+    // Length is rounded up to whole pages.
+    const uint64_t second = m.mmap(0, PAGE, FLAGS_ANONYMOUS);
+    QCOMPARE(second, first + 4 * PAGE);
+
+    QCOMPARE(m.cache.read_u32(Address(first + 8)), uint32_t(0));
+    m.cache.write_u32(Address(first + 8), 0xdeadbeef);
+    m.cache.write_u32(Address(second), 0x12345678);
+    m.cache.flush();
+    QVERIFY(m.allocated(first + 8));
+    m.cache.write_u32(Address(first + 8), 0xcafecafe);
+    QVERIFY(m.cached(first + 8));
+
+    // Unmapped pages are released and their dirty lines dropped, nothing is written back.
+    QCOMPARE(m.munmap(first, 4 * PAGE), uint64_t(0));
+    QVERIFY(!m.allocated(first + 8));
+    QVERIFY(!m.cached(first + 8));
+    m.cache.flush();
+    QVERIFY(!m.allocated(first + 8));
+    QCOMPARE(m.cache.read_u32(Address(first + 8)), uint32_t(0));
+    QCOMPARE(m.cache.read_u32(Address(second)), uint32_t(0x12345678));
+
+    QCOMPARE(int64_t(m.munmap(first + 1, PAGE)), int64_t(-TARGET_EINVAL));
+    QCOMPARE(int64_t(m.mmap(0, 0, FLAGS_ANONYMOUS)), int64_t(-TARGET_EINVAL));
+}
+
+void TestOsSyscall::ossyscall_mmap_fixed() {
+    OsemuMachine m;
+    const uint64_t base = m.mmap(0, 2 * PAGE, FLAGS_ANONYMOUS);
+    m.cache.write_u32(Address(base), 1);
+    m.cache.write_u32(Address(base + PAGE), 2);
+
+    // Only the overlapping page of the old mapping is replaced, dirty lines are dropped.
+    QCOMPARE(m.mmap(base + PAGE, PAGE, FLAGS_ANONYMOUS | FLAG_MAP_FIXED), base + PAGE);
+    QVERIFY(!m.cached(base + PAGE));
+    m.cache.flush();
+    QVERIFY(!m.allocated(base + PAGE));
+    QCOMPARE(m.cache.read_u32(Address(base)), uint32_t(1));
+    QCOMPARE(m.cache.read_u32(Address(base + PAGE)), uint32_t(0));
+
+    // Fixed mapping replaces memory outside of previous mappings too.
+    m.cache.write_u32(0x70000000_addr, 5);
+    QCOMPARE(m.mmap(0x70000000, PAGE, FLAGS_ANONYMOUS | FLAG_MAP_FIXED), uint64_t(0x70000000));
+    QCOMPARE(m.cache.read_u32(0x70000000_addr), uint32_t(0));
+
+    QCOMPARE(int64_t(m.mmap(0x70000004, PAGE, FLAGS_ANONYMOUS | FLAG_MAP_FIXED)),
+             int64_t(-TARGET_EINVAL));
+}
+
+void TestOsSyscall::ossyscall_mmap_file() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QByteArray contents(2 * PAGE + 100, 0);
+    for (int i = 0; i < contents.size(); i++) {
+        contents[i] = char(i * 7 + i / 256);
+    }
+    QFile file(dir.filePath("data.bin"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(contents);
+    file.close();
+
+    OsemuMachine m(dir.path());
+    const int fd = m.open("/data.bin");
+    QVERIFY(fd >= 3);
+    const uint64_t base = m.mmap(0, 3 * PAGE, FLAG_MAP_PRIVATE, fd, PAGE);
+    QCOMPARE(base, uint64_t(0x60000000));
+    // Contents are read on the first touch, the mapping outlives the descriptor.
+    QVERIFY(!m.allocated(base));
+    m.close(fd);
+    QCOMPARE(m.cache.read_u8(Address(base)), uint8_t(contents[PAGE]));
+    QCOMPARE(m.cache.read_u8(Address(base + PAGE + 99)), uint8_t(contents[2 * PAGE + 99]));
+    // Rest of the page past the end of the file reads as zero.
+    QCOMPARE(m.cache.read_u8(Address(base + PAGE + 100)), uint8_t(0));
+    QCOMPARE(m.cache.read_u32(Address(base + 2 * PAGE)), uint32_t(0));
+
+    // Private mapping, stores are not written back to the file.
+    m.cache.write_u8(Address(base), 0x5a);
+    m.cache.flush();
+    QCOMPARE(m.cache.read_u8(Address(base)), uint8_t(0x5a));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), contents);
+    file.close();
+
+    // Unmapped file pages read as zero when mapped again.
+    QCOMPARE(m.munmap(base, PAGE), uint64_t(0));
+    QCOMPARE(m.mmap(base, PAGE, FLAGS_ANONYMOUS | FLAG_MAP_FIXED), base);
+    QCOMPARE(m.cache.read_u8(Address(base + 1)), uint8_t(0));
+    QCOMPARE(m.cache.read_u8(Address(base + PAGE)), uint8_t(contents[2 * PAGE]));
+
+    QCOMPARE(int64_t(m.mmap(0, PAGE, FLAG_MAP_PRIVATE, fd)), int64_t(-TARGET_EBADF));
+    QCOMPARE(int64_t(m.mmap(0, PAGE, FLAG_MAP_PRIVATE, 42)), int64_t(-TARGET_EBADF));
+}
+
+void TestOsSyscall::ossyscall_brk() {
+    OsemuMachine m;
+    QCOMPARE(m.brk(0), uint64_t(0));
+    const uint64_t heap = 0x10000;
+    QCOMPARE(m.brk(heap), heap);
+    QCOMPARE(m.brk(heap + 2 * PAGE), heap + 2 * PAGE);
+    m.cache.write_u32(Address(heap + 4), 3);
+    m.cache.write_u32(Address(heap + PAGE + 4), 7);
+    m.cache.flush();
+
+    // Released part of the heap is zero after it grows again.
+    QCOMPARE(m.brk(heap + PAGE), heap + PAGE);
+    QVERIFY(!m.allocated(heap + PAGE + 4));
+    QCOMPARE(m.brk(heap + 2 * PAGE), heap + 2 * PAGE);
+    QCOMPARE(m.cache.read_u32(Address(heap + PAGE + 4)), uint32_t(0));
+    QCOMPARE(m.cache.read_u32(Address(heap + 4)), uint32_t(3));
+
+    // Requests below the start of the heap keep the current break.
+    QCOMPARE(m.brk(heap - PAGE), heap + 2 * PAGE);
+}
+
+QTEST_APPLESS_MAIN(TestOsSyscall)
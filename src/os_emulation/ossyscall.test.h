@@ -0,0 +1,16 @@
+#ifndef OSSYSCALL_TEST_H
+#define OSSYSCALL_TEST_H
+
+#include <QtTest>
+
+class TestOsSyscall : public QObject {
+    Q_OBJECT
+
+private slots:
+    static void ossyscall_mmap_anonymous();
+    static void ossyscall_mmap_fixed();
+    static void ossyscall_mmap_file();
+    static void ossyscall_brk();
+};
+
+#endif // OSSYSCALL_TEST_H
@@ -11,6 +11,7 @@
 
 #define open _open
 #define close _close
+#define dup _dup
 #define read _read
 #define write _write
 #define ftruncate _chsize_s
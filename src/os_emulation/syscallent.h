@@ -219,7 +219,7 @@
     [212] = { 3, HANDLER(syscall_default_handler), "recvmsg" },
     [213] = { 3, HANDLER(syscall_default_handler), "readahead" },
     [214] = { 1, HANDLER(do_sys_brk), "brk" },
-    [215] = { 2, HANDLER(syscall_default_handler), "munmap" },
+    [215] = { 2, HANDLER(do_sys_munmap), "munmap" },
     [216] = { 5, HANDLER(syscall_default_handler), "mremap" },
     [217] = { 5, HANDLER(syscall_default_handler), "add_key" },
     [218] = { 4, HANDLER(syscall_default_handler), "request_key" },